@@ -10,8 +10,9 @@ macro(add_catch2_test name)
     ${TEST_NAME} PRIVATE 
       "${CMAKE_CURRENT_SOURCE_DIR}/../"
   )
+  # warnings inside Eigen must not break the build with -Werror
   target_include_directories(
-    ${TEST_NAME} PRIVATE 
+    ${TEST_NAME} SYSTEM PRIVATE 
       "${CMAKE_CURRENT_SOURCE_DIR}/../deps/eigen"
   )
 #   target_include_directories(
@@ -8,35 +8,62 @@ namespace OptLib
 {
     namespace ConcreteFunc
     {
+		/// @brief Restriction of f to the ray x0 + gamma * dir, i.e., phi(gamma) = f(x0 + gamma * dir)
 		template <size_t dim>
-		class FuncAlongGradDirection : public FuncInterface::IFuncWithGrad<1>
+		class FuncAlongDirection : public FuncInterface::IFuncWithGrad<1>
 		{
 		public:
-			FuncAlongGradDirection(
+			FuncAlongDirection(
 				const FuncInterface::IFuncWithGrad<dim>* const f_pointer, 
-				const Point<dim> &x0_) noexcept : 
-				x0{x0_}, grad0{f_pointer->grad(x0_)}, f{*f_pointer} 
+				const Point<dim> &x0_, 
+				const Point<dim> &dir_) noexcept : 
+				x0{x0_}, dir{dir_}, f{*f_pointer} 
 				{}
 
 			double operator()(const Point<1> &gamma) const override
 			{
-				return f(x0 - grad0 * gamma[0]);
+				return f(PointAt(gamma[0]));
 			}
 
 			Point<1> grad(const Point<1> &gamma) const override
 			{
-				Point<dim> gr = f.grad(x0 - grad0 * gamma[0]);
+				Point<dim> gr = f.grad(PointAt(gamma[0]));
 
-				return Point<1>{-dot_product(gr, grad0)};
+				return Point<1>{dot_product(gr, dir)};
+			}
+
+			/// @brief Maps the 1D argument back to the dim-D space of arguments of f
+			Point<dim> PointAt(double gamma) const
+			{
+				return x0 + dir * gamma;
 			}
 
 		protected:
 			Point<dim> x0;
-			Grad<dim> grad0;
+			Point<dim> dir;
 
 			const FuncInterface::IFuncWithGrad<dim>& f; // function to optimize
 		};
 
+		template <size_t dim>
+		class FuncAlongGradDirection : public FuncAlongDirection<dim>
+		{
+		public:
+			FuncAlongGradDirection(
+				const FuncInterface::IFuncWithGrad<dim>* const f_pointer, 
+				const Point<dim> &x0_) noexcept : 
+				FuncAlongGradDirection{f_pointer, x0_, f_pointer->grad(x0_)} 
+				{}
+
+			/// @brief The gradient at x0 is already known and is not recalculated
+			FuncAlongGradDirection(
+				const FuncInterface::IFuncWithGrad<dim>* const f_pointer, 
+				const Point<dim> &x0_, 
+				const Grad<dim> &grad0) noexcept : 
+				FuncAlongDirection<dim>{f_pointer, x0_, -1.0 * grad0} 
+				{}
+		};
+
     }
 }
 
@@ -15,14 +15,6 @@ namespace OptLib
 		*/
 		class Function : public FuncInterface::IFuncWithGrad<1>
 		{
-		public:
-			Function()
-			{
-#ifdef DEBUG_LIB
-				std::cout << "Parabola  x^2  has been instantiated.\n";
-#endif // DEBUG_LIB
-			}
-
 		public:
 			double operator()(const Point<1> &x) const override
 			{
@@ -51,12 +43,6 @@ namespace OptLib
 		class Function2DWithHessNoGrad : public FuncInterface::IFunc<2>, public FuncInterface::IHess<2>
 		{
 		public:
-			Function2DWithHessNoGrad()
-			{
-#ifdef DEBUG_LIB
-				std::cout << "Parabola  x^2 + y^2  has been instantiated. No gradient is defined.\n";
-#endif // DEBUG_LIB
-			}
 			double operator()(const Point<2> &x) const override
 			{
 				return x[0] * x[0] + x[1] * x[1];
@@ -72,14 +58,6 @@ namespace OptLib
 		template <size_t dim>
 		class Func : public FuncInterface::IFunc<dim>
 		{
-		public:
-			Func()
-			{
-#ifdef DEBUG_LIB
-				std::cout << "Paraboloid  has been instantiated.\n";
-#endif // DEBUG_LIB
-			}
-
 		public:
 			double operator()(const Point<dim> &x) const override
 			{
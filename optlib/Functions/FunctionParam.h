@@ -16,16 +16,19 @@ namespace OptLib
 			}
 		};
 
-		class LinearFuncWithGrad : public LinearFunc, FuncParamInterface::IFuncParamGrad<1, 1>
+		class LinearFuncWithGrad : public FuncParamInterface::IFuncParamWithGrad<1, 1>
 		{
 		public:
+			using FuncParamInterface::IFuncParamWithGrad<1, 1>::operator();
+			using FuncParamInterface::IFuncParamWithGrad<1, 1>::GradP;
+
 			double operator() (const Point<1>& x, const Point<1>& a) const override
 			{
 				return x[0] * a[0];
 			}
-			auto GradP(const Point<1>& x, const Point<1>& a) const -> Grad<1> override
+			auto GradP(const Point<1>& x, const Point<1>&) const -> Grad<1> override
 			{
-				return Grad<1>{a};
+				return Grad<1>{x};
 			}
 		};
 	} // ConcreteFuncParam
@@ -41,6 +41,77 @@ namespace OptLib
 			return out;
 		}
 
+		/// @brief Evaluates the points concurrently on the OpenMP thread pool.
+		/// f must be safe to call from several threads
+		template <size_t count, size_t dim>
+		static auto CreateFromPoints(SetOfPoints<count, Point<dim>> &&p, const IFunc<dim> *f)
+		{
+			SetOfPoints<count, PointVal<dim>> out;
+#pragma omp parallel for schedule(dynamic, 1) if (count > 1)
+			for (long long i = 0; i < static_cast<long long>(count); ++i)
+			{
+				double val{(*f)(p[i])};
+				out[i] = PointVal<dim>{std::move(p[i]), val};
+			}
+			return out;
+		}
+
+		/// @brief Function that can evaluate a contiguous block of points at once, e.g., with SIMD or on an accelerator.
+		/// The default implementation falls back to the scalar operator()
+		template <size_t dim>
+		class IFuncBatch : public IFunc<dim>
+		{
+		public:
+			using IFunc<dim>::operator();
+
+			virtual void operator()(const Point<dim> *x, double *out, size_t n) const
+			{
+				for (size_t i = 0; i < n; ++i)
+					out[i] = (*this)(x[i]);
+			}
+		};
+
+		/// @brief Evaluates n points with the batch path of f if f has it
+		template <size_t dim>
+		static void EvaluateBatch(const IFunc<dim> *f, const Point<dim> *x, double *out, size_t n)
+		{
+			if (auto fb = dynamic_cast<const IFuncBatch<dim> *>(f))
+				(*fb)(x, out, n);
+			else
+				for (size_t i = 0; i < n; ++i)
+					out[i] = (*f)(x[i]);
+		}
+
+		/// @brief The same as EvaluateBatch, but a function without the batch path is evaluated
+		/// at the n points concurrently on the OpenMP threads. f must be thread-safe.
+		/// The methods built on it draw their random numbers on the calling thread before the call,
+		/// so their results do not depend on the number of threads
+		template <size_t dim>
+		static void EvaluateParallel(const IFunc<dim> *f, const Point<dim> *x, double *out, size_t n)
+		{
+			if (auto fb = dynamic_cast<const IFuncBatch<dim> *>(f))
+				(*fb)(x, out, n);
+			else
+			{
+#pragma omp parallel for schedule(dynamic, 1)
+				for (long long i = 0; i < static_cast<long long>(n); ++i)
+					out[i] = (*f)(x[i]);
+			}
+		}
+
+		/// @brief Values of lanes independent 1D problems packed together, e.g., for SIMD
+		template <size_t lanes>
+		using Lanes = std::array<double, lanes>;
+
+		/// @brief lanes independent 1D functions evaluated together. The i-th function is evaluated at x[i].
+		/// One virtual call serves all the lanes
+		template <size_t lanes>
+		class IFuncLanes
+		{
+		public:
+			virtual void operator()(const Lanes<lanes> &x, Lanes<lanes> &out) const = 0;
+		};
+
 		template <size_t dim>
 		class IGrad
 		{
@@ -27,13 +27,21 @@ namespace OptLib
 					out[i] = (*this)(x[i], a);
 				return out;
 			}
+
+			/// @brief Values at n arguments for the same parameters. Models override it with a loop that vectorizes
+			virtual void operator()(const Point<dimX> *x, const Point<dimP> &a, double *out, size_t n) const
+			{
+				for (size_t k = 0; k < n; ++k)
+					out[k] = (*this)(x[k], a);
+			}
 		};
 
+		/// @brief Gradient of f(X | P) with respect to the parameters
 		template <size_t dimX, size_t dimP>
 		class IFuncParamGrad
 		{
 		public:
-			virtual Grad<dimX> GradP(const Point<dimX> &x, const Point<dimP> &a) const = 0;
+			virtual Grad<dimP> GradP(const Point<dimX> &x, const Point<dimP> &a) const = 0;
 		};
 
 		template <size_t dimX, size_t dimP>
@@ -56,6 +64,23 @@ namespace OptLib
 		template <size_t dimX, size_t dimP>
 		class IFuncParamWithGrad : public IFuncParam<dimX, dimP>, public IFuncParamGrad<dimX, dimP>
 		{
+		public:
+			using IFuncParam<dimX, dimP>::operator();
+			using IFuncParamGrad<dimX, dimP>::GradP;
+
+			/// @brief Values and gradients at n arguments for the same parameters.
+			/// The gradients are stored as a dimP x n column-major matrix: J[i * n + k] = df(x[k] | a) / da_i,
+			/// so that the loops over the arguments vectorize. Models override it to compute both in one pass
+			virtual void GradP(const Point<dimX> *x, const Point<dimP> &a, double *out, double *J, size_t n) const
+			{
+				for (size_t k = 0; k < n; ++k)
+				{
+					out[k] = (*this)(x[k], a);
+					Grad<dimP> g{GradP(x[k], a)};
+					for (size_t i = 0; i < dimP; ++i)
+						J[i * n + k] = g[i];
+				}
+			}
 		};
 	} // FuncParamInterface
 } // OptLib
@@ -2,6 +2,7 @@
 #define FUNCTIONWITHMEMORY
 
 #include <atomic>
+#include <limits>
 #include "FuncInterface.h"
 #include "FuncParamInterface.h"
 
@@ -27,7 +28,7 @@ namespace OptLib
 				return (*f)(x);
 			}
 
-			mutable atomic_size_t Counter {0ull};
+			mutable std::atomic_size_t Counter {0ull};
 		};
 
 		/// <summary>
@@ -47,7 +48,40 @@ namespace OptLib
 				return (*f)(x, a);
 			}
 
-			mutable atomic_size_t Counter{0ull};
+			mutable std::atomic_size_t Counter{0ull};
+		};
+
+		/// <summary>
+		/// Function Interface f(x) that remembers the best point it has been evaluated at.
+		/// Not thread-safe, intended for a single optimization thread
+		/// </summary>
+		template <size_t dim>
+		class IBestFunc : public FuncInterface::IFunc<dim>
+		{
+			const FuncInterface::IFunc<dim>* f;
+		public:
+
+			IBestFunc(const FuncInterface::IFunc<dim>* f_pointer) : f{ f_pointer } {}
+
+			double operator () (const Point<dim>& x) const override
+			{
+				double val{ (*f)(x) };
+				if (val < ItsBest.Val)
+					ItsBest = PointVal<dim>{ x, val };
+				return val;
+			}
+
+			/// @brief Registers a point evaluated elsewhere
+			void Seed(const PointVal<dim>& v) const
+			{
+				if (v.Val < ItsBest.Val)
+					ItsBest = v;
+			}
+
+			const PointVal<dim>& Best() const { return ItsBest; }
+
+		protected:
+			mutable PointVal<dim> ItsBest{ Point<dim>{}, std::numeric_limits<double>::infinity() };
 		};
 	} // FuncWithCounter
 } // OptLib
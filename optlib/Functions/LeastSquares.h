@@ -0,0 +1,147 @@
+#ifndef LEASTSQUARES_H
+#define LEASTSQUARES_H
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "Interface/FuncInterface.h"
+#include "Interface/FuncParamInterface.h"
+
+namespace OptLib
+{
+    namespace ConcreteFunc
+    {
+		/// @brief Least-squares objective of fitting the model f(X | P) to the samples (X_k, Y_k):
+		/// F(a) = 1/2 sum_k r_k(a)^2 with the residuals r_k(a) = f(X_k | a) - Y_k, as a function of the parameters.
+		/// The samples are processed in chunks of Chunk: every chunk is one batch call of the model and
+		/// the chunks run concurrently on the OpenMP threads. The partial sums of the chunks are added
+		/// in the order of the chunks, so the result does not depend on the number of threads.
+		/// The model must be thread-safe
+		template <size_t dimX, size_t dimP>
+		class LeastSquares : public FuncInterface::IFunc<dimP>
+		{
+		public:
+			using model_type = FuncParamInterface::IFuncParamWithGrad<dimX, dimP>;
+
+			// large enough to amortize a batch call, small enough for the Jacobian of a chunk to stay in L1/L2
+			static constexpr size_t Chunk = 256;
+
+			LeastSquares(const model_type *f, std::vector<Point<dimX>> &&x, std::vector<double> &&y) :
+				Model{f}, X(std::move(x)), Y(std::move(y)) // with braces, the vector would initialize one Point<dimX>
+			{}
+
+			size_t Size() const { return X.size(); }
+
+			double operator()(const Point<dimP> &a) const override
+			{
+				const long long chunks = static_cast<long long>(Chunks());
+				std::vector<double> partial(chunks);
+#pragma omp parallel
+				{
+					std::vector<double> r(Chunk);
+#pragma omp for schedule(dynamic, 1)
+					for (long long c = 0; c < chunks; ++c)
+					{
+						const size_t k0 = static_cast<size_t>(c) * Chunk;
+						const size_t n = std::min(Chunk, Size() - k0);
+						(*Model)(X.data() + k0, a, r.data(), n);
+						partial[c] = SumOfSquares(r.data(), Y.data() + k0, n);
+					}
+				}
+				double s = 0.0;
+				for (double p : partial)
+					s += p;
+				return 0.5 * s;
+			}
+
+			/// @brief Assembles the normal equations at a: JtJ = J^T J and Jtr = J^T r, where J is the Jacobian of
+			/// the residuals. Only the upper triangle of every chunk is accumulated, JtJ is returned in full
+			/// @return F(a)
+			double Normal(const Point<dimP> &a, Hess<dimP> &JtJ, Grad<dimP> &Jtr) const
+			{
+				// upper triangle of J^T J, J^T r and r^T r of every chunk
+				constexpr size_t tri = dimP * (dimP + 1) / 2;
+				constexpr size_t stride = tri + dimP + 1;
+				const long long chunks = static_cast<long long>(Chunks());
+				std::vector<double> partial(chunks * stride);
+#pragma omp parallel
+				{
+					std::vector<double> r(Chunk);
+					std::vector<double> J(dimP * Chunk);
+#pragma omp for schedule(dynamic, 1)
+					for (long long c = 0; c < chunks; ++c)
+					{
+						const size_t k0 = static_cast<size_t>(c) * Chunk;
+						const size_t n = std::min(Chunk, Size() - k0);
+						double *out = partial.data() + c * stride;
+
+						Model->GradP(X.data() + k0, a, r.data(), J.data(), n);
+						out[tri + dimP] = SumOfSquares(r.data(), Y.data() + k0, n); // r now holds the residuals
+
+						size_t t = 0;
+						for (size_t i = 0; i < dimP; ++i)
+						{
+							const double *Ji = J.data() + i * n;
+							for (size_t j = i; j < dimP; ++j)
+								out[t++] = Dot(Ji, J.data() + j * n, n);
+							out[tri + i] = Dot(Ji, r.data(), n);
+						}
+					}
+				}
+
+				std::vector<double> sum(stride, 0.0);
+				for (long long c = 0; c < chunks; ++c)
+				{
+					const double *p = partial.data() + c * stride;
+					for (size_t t = 0; t < stride; ++t)
+						sum[t] += p[t];
+				}
+
+				size_t t = 0;
+				for (size_t i = 0; i < dimP; ++i)
+				{
+					for (size_t j = i; j < dimP; ++j, ++t)
+					{
+						JtJ[i][j] = sum[t];
+						JtJ[j][i] = sum[t];
+					}
+					Jtr[i] = sum[tri + i];
+				}
+				return 0.5 * sum[tri + dimP];
+			}
+
+		protected:
+			const model_type *Model;
+			std::vector<Point<dimX>> X;
+			std::vector<double> Y;
+
+			size_t Chunks() const { return (Size() + Chunk - 1) / Chunk; }
+
+			/// @brief Turns the values f into the residuals f - y and returns the sum of their squares
+			static double SumOfSquares(double *f, const double *y, size_t n)
+			{
+				double s = 0.0;
+#pragma omp simd reduction(+ : s)
+				for (size_t k = 0; k < n; ++k)
+				{
+					const double rk = f[k] - y[k];
+					f[k] = rk;
+					s += rk * rk;
+				}
+				return s;
+			}
+
+			static double Dot(const double *a, const double *b, size_t n)
+			{
+				double s = 0.0;
+#pragma omp simd reduction(+ : s)
+				for (size_t k = 0; k < n; ++k)
+					s += a[k] * b[k];
+				return s;
+			}
+		};
+	} // ConcreteFunc
+} // OptLib
+
+#endif
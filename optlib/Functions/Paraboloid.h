@@ -43,11 +43,6 @@ namespace OptLib
 						coef_matrix[i][j] = temp;
 						coef_matrix[j][i] = temp;
 					}
-#ifdef DEBUG_LIB
-				std::cout << "Paraboloid in " << dim << "D space with Hessian "
-						  << hessian << " has been instantiated\n";
-				std::cout << "Its coefficient matrix A for xAx is " << CoefMatrix() << '\n';
-#endif // DEBUG_LIB
 			}
 
 			auto operator()(const Point<dim> &x) const -> typename Point<dim>::value_type override
@@ -0,0 +1,159 @@
+#ifndef ASKTELL_H
+#define ASKTELL_H
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../Points/SetOfPoints/PointVals/PointVal.h"
+
+#include "../Functions/Interface/FuncInterface.h"
+
+namespace OptLib
+{
+	namespace OptimizerInterface
+	{
+		/// @brief Ask/tell driver of a method for objectives evaluated outside of the optimizer, e.g., by a queue of jobs.
+		/// Ask() returns the points to evaluate, Tell() takes their values in the same order and advances the method.
+		/// Ask() called again before Tell() returns the same points. The trajectory is the same as that of Proceed with f.
+		/// The state is created by the first Tell(): the first Ask() returns the points the state evaluates on creation.
+		/// Tell() without a pending Ask() or with a wrong number of values throws std::logic_error
+		/// @tparam derived The driver of a concrete method, which provides Propose(std::vector<Point<dim>>&) that fills the points
+		/// of the next batch and Complete(const double*) that consumes their values
+		/// @tparam params StateParams::*Params of the method
+		template<typename derived, typename params>
+		class AskTell
+		{
+		public:
+			using state = typename params::StateType;
+			constexpr static size_t dim = state::arg_count;
+
+			explicit AskTell(params prm) : Prm{ std::move(prm) } {}
+
+			AskTell(const AskTell&) = delete;
+			AskTell& operator=(const AskTell&) = delete;
+
+			const std::vector<Point<dim>>& Ask()
+			{
+				if (!Pending)
+				{
+					Asked.clear();
+					if (!ItsState)
+						Asked = Initial();
+					else
+						static_cast<derived*>(this)->Propose(Asked);
+					Pending = true;
+				}
+				return Asked;
+			}
+
+			/// @param vals Values at the points of the last Ask()
+			void Tell(const double* vals)
+			{
+				if (!Pending)
+					throw std::logic_error{ "AskTell: Tell() without a pending Ask()" };
+				if (!ItsState)
+				{
+					Replay f{ Asked, vals };
+					ItsState.emplace(Prm.CreateState(&f));
+					if (f.Missed)
+					{ // the creation evaluated a point that was not asked, the state holds NaN
+						ItsState.reset();
+						throw std::logic_error{ "AskTell: the state is created at a point that was not asked" };
+					}
+				}
+				else
+					static_cast<derived*>(this)->Complete(vals);
+				Pending = false;
+			}
+
+			void Tell(const std::vector<double>& vals)
+			{
+				if (Pending && vals.size() != Asked.size())
+					throw std::logic_error{ "AskTell: Tell() takes one value per asked point" };
+				Tell(vals.data());
+			}
+
+			/// @brief The state exists after the first Tell()
+			bool Started() const { return ItsState.has_value(); }
+			const state& State() const { return *ItsState; }
+			const PointVal<dim>& Guess() const { return ItsState->Guess(); }
+			bool IsConverged(double abs_tol, double rel_tol) const
+			{
+				return ItsState && ItsState->IsConverged(abs_tol, rel_tol);
+			}
+
+		protected:
+			params Prm;
+			std::optional<state> ItsState;
+			std::vector<Point<dim>> Asked;
+			bool Pending{ false };
+
+			static bool Less(const Point<dim>& a, const Point<dim>& b)
+			{
+				return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+			}
+
+			/// @brief Records the points the state is evaluated at on creation. They do not depend on the values,
+			/// as the creation only evaluates a start and at most sorts it
+			class Recorder : public FuncInterface::IFunc<dim>
+			{
+			public:
+				mutable std::vector<Point<dim>> Points;
+				double operator()(const Point<dim>& x) const override
+				{
+					std::lock_guard<std::mutex> lock{ m }; // the creation may evaluate on the OpenMP threads
+					Points.push_back(x);
+					return 0.0;
+				}
+			protected:
+				mutable std::mutex m;
+			};
+
+			/// @brief Returns the told values at the recorded points, NaN at any other point, which sets Missed
+			class Replay : public FuncInterface::IFunc<dim>
+			{
+			public:
+				mutable std::atomic<bool> Missed{ false }; // the creation may evaluate on the OpenMP threads
+
+				Replay(const std::vector<Point<dim>>& x, const double* v)
+				{
+					Table.reserve(x.size());
+					for (size_t k = 0; k < x.size(); ++k)
+						Table.emplace_back(x[k], v[k]);
+					std::sort(Table.begin(), Table.end(), [](const auto& a, const auto& b) { return Less(a.P, b.P); });
+				}
+				double operator()(const Point<dim>& x) const override
+				{
+					auto it = std::lower_bound(Table.begin(), Table.end(), x, [](const PointVal<dim>& a, const Point<dim>& b) { return Less(a.P, b); });
+					if (it != Table.end() && !Less(x, it->P))
+						return it->Val;
+					Missed = true;
+					return std::numeric_limits<double>::quiet_NaN();
+				}
+			protected:
+				std::vector<PointVal<dim>> Table;
+			};
+
+			/// @brief The distinct points of the creation in the lexicographic order, which does not depend on the threads
+			std::vector<Point<dim>> Initial() const
+			{
+				params copy{ Prm };
+				Recorder f;
+				copy.CreateState(&f);
+				std::vector<Point<dim>> out(std::move(f.Points));
+				std::sort(out.begin(), out.end(), Less);
+				out.erase(std::unique(out.begin(), out.end(), [](const Point<dim>& a, const Point<dim>& b) { return !Less(a, b) && !Less(b, a); }), out.end());
+				return out;
+			}
+		};
+	} // OptimizerInterface
+} // OptLib
+
+#endif
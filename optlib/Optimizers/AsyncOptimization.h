@@ -0,0 +1,152 @@
+#ifndef ASYNCOPTIMIZATION_H
+#define ASYNCOPTIMIZATION_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+#include "../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../Points/SetOfPoints/PointVals/PointVal.h"
+
+namespace OptLib
+{
+	/// @brief Progress of a running optimization
+	template<size_t dim>
+	struct Progress
+	{
+		PointVal<dim> Guess;
+		size_t Iterations;
+		// calls of f, 0 if f does not count them
+		size_t Evaluations;
+	};
+
+	/// @brief Progress published by the optimization thread and read by any other thread (Boehm, 2012, "Can seqlocks get along
+	/// with programming language memory models?"). The writer never waits: a publication is dim + 3 relaxed stores between
+	/// two increments of the sequence. A reader retries only if a publication overlapped its read.
+	/// All the fields are atomics, so a torn read is detected instead of being a data race
+	template<size_t dim>
+	class ProgressSeqLock
+	{
+	public:
+		/// @brief Called by the single writer
+		void Publish(const PointVal<dim>& guess, size_t iterations, size_t evaluations)
+		{
+			const size_t s = Seq.load(std::memory_order_relaxed);
+			Seq.store(s + 1, std::memory_order_relaxed); // odd: a publication is in progress
+			std::atomic_thread_fence(std::memory_order_release);
+			for (size_t i = 0; i < dim; ++i)
+				Vals[i].store(guess.P[i], std::memory_order_relaxed);
+			Vals[dim].store(guess.Val, std::memory_order_relaxed);
+			Iter.store(iterations, std::memory_order_relaxed);
+			Evals.store(evaluations, std::memory_order_relaxed);
+			Seq.store(s + 2, std::memory_order_release);
+		}
+
+		Progress<dim> Read() const
+		{
+			Progress<dim> out{};
+			for (;;)
+			{
+				const size_t s = Seq.load(std::memory_order_acquire);
+				if (s & 1)
+				{
+					std::this_thread::yield();
+					continue;
+				}
+				for (size_t i = 0; i < dim; ++i)
+					out.Guess.P[i] = Vals[i].load(std::memory_order_relaxed);
+				out.Guess.Val = Vals[dim].load(std::memory_order_relaxed);
+				out.Iterations = Iter.load(std::memory_order_relaxed);
+				out.Evaluations = Evals.load(std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (Seq.load(std::memory_order_relaxed) == s)
+					return out;
+			}
+		}
+
+	protected:
+		std::atomic<size_t> Seq{ 0 };
+		std::array<std::atomic<double>, dim + 1> Vals{};
+		std::atomic<size_t> Iter{ 0 };
+		std::atomic<size_t> Evals{ 0 };
+	};
+
+	/// @brief Runs a job on a new detached thread. An executor is any callable that takes a job and runs it
+	/// once on some thread, e.g., a thread pool
+	struct ThreadExecutor
+	{
+		template<typename job>
+		void operator()(job&& Job) const
+		{
+			std::thread{ std::forward<job>(Job) }.detach();
+		}
+	};
+
+	/// @brief Handle of an optimization running on an executor, see Optimizer::OptimizeAsync.
+	/// The cancellation is cooperative: the loop stops before its next iteration. The handle is move-only,
+	/// its destructor cancels the optimization and waits for it, so the state and f may be destroyed after the handle
+	template<size_t dim>
+	class AsyncOptimization
+	{
+	public:
+		/// @brief What the job and the handle share. The job touches nothing else after it sets the result
+		struct Shared
+		{
+			ProgressSeqLock<dim> Board;
+			std::stop_source Stop;
+			std::promise<PointVal<dim>> Done;
+		};
+
+		explicit AsyncOptimization(std::shared_ptr<Shared> s) :
+			S{ std::move(s) },
+			Result{ S->Done.get_future() }
+		{}
+
+		AsyncOptimization(AsyncOptimization&&) noexcept = default;
+		AsyncOptimization& operator=(AsyncOptimization&&) noexcept = default;
+
+		~AsyncOptimization()
+		{
+			if (Result.valid())
+			{
+				Cancel();
+				Result.wait();
+			}
+		}
+
+		void Cancel() { S->Stop.request_stop(); }
+		bool CancelRequested() const { return S->Stop.stop_requested(); }
+		std::stop_token Token() const { return S->Stop.get_token(); }
+
+		/// @brief The guess, the iterations and the evaluations after the last finished iteration
+		Progress<dim> Snapshot() const { return S->Board.Read(); }
+
+		bool Ready() const { return WaitFor(std::chrono::seconds{ 0 }); }
+
+		template<typename rep, typename period>
+		bool WaitFor(const std::chrono::duration<rep, period>& timeout) const
+		{
+			return Result.wait_for(timeout) == std::future_status::ready;
+		}
+
+		void Wait() const { Result.wait(); }
+
+		/// @brief Waits for the end of the optimization and returns its final guess, cancelled or not.
+		/// Rethrows an exception thrown by the optimization
+		PointVal<dim> Get()
+		{
+			return Result.get();
+		}
+
+	protected:
+		std::shared_ptr<Shared> S;
+		std::future<PointVal<dim>> Result;
+	};
+} // OptLib
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef MULTISTART_H
+#define MULTISTART_H
+
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include "../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../Points/SetOfPoints/PointVals/PointVal.h"
+
+#include "OverallOptimizer.h"
+
+namespace OptLib
+{
+	/// @brief Early cancellation of the starts that are not expected to beat the incumbent
+	struct MultiStartParams
+	{
+		// the progress of a start is measured over this number of iterations, 0 disables the cancellation
+		size_t patience;
+		// a start is cancelled if its gap to the incumbent exceeds the progress extrapolated linearly 
+		// over the rest of its iteration budget, multiplied by this factor
+		double optimism;
+	};
+
+	/// @brief Outcome of a single start
+	template<size_t dim>
+	struct StartStatistics
+	{
+		PointVal<dim> Result;
+		size_t Iterations;
+		bool Converged;
+		bool Cancelled;
+	};
+
+	template<size_t dim>
+	struct MultiStartResult
+	{
+		PointVal<dim> Best;
+		size_t BestStart;
+		std::vector<StartStatistics<dim>> Starts;
+	};
+
+	/// @brief Runs many independent optimizations from different starts on the OpenMP thread pool.
+	/// Starts are handed out dynamically, so threads that finish early take the remaining ones.
+	/// The best result is shared between the threads. f must be thread-safe.
+	/// An exception thrown by a start does not stop the other starts; the first one caught is rethrown after all of them finish
+	/// @tparam params StateParams::*Params of the method, which provide OptAlgo, StateType, and CreateState
+	template<typename params, typename func = typename params::StateType::func_type>
+	class MultiStartOptimizer
+	{
+	public:
+		using state = typename params::StateType;
+		using algo = typename params::OptAlgo;
+		constexpr static size_t arg_count = state::arg_count;
+
+	public:
+		MultiStartOptimizer(func* f_, const OptimizerParams& prm, const MultiStartParams& mprm = MultiStartParams{ 0, 1.0 }) :
+			f{ f_ },
+			Prm{ prm },
+			MPrm{ mprm }
+		{}
+
+		/// @param count Number of starts
+		/// @param Generate Start for the i-th run, e.g., Point<dim> or a simplex
+		/// @param Factory Makes the params of the method from a start
+		template<typename generator, typename factory>
+		MultiStartResult<arg_count> Optimize(size_t count, generator&& Generate, factory&& Factory)
+		{
+			MultiStartResult<arg_count> out{};
+			out.Starts.resize(count);
+			out.BestStart = count;
+			out.Best.Val = std::numeric_limits<double>::infinity();
+			Incumbent = std::numeric_limits<double>::infinity();
+
+			std::mutex m;
+			std::exception_ptr failure; // exceptions must not leave the parallel region
+
+#pragma omp parallel for schedule(dynamic, 1)
+			for (long long i = 0; i < static_cast<long long>(count); ++i)
+			{
+				try
+				{
+					params prm{ Factory(Generate(static_cast<size_t>(i))) };
+					state State{ prm.CreateState(f) };
+
+					StartStatistics<arg_count> stat{ RunStart(State) };
+
+					std::lock_guard<std::mutex> lock{ m };
+					if (stat.Result.Val < out.Best.Val)
+					{
+						out.Best = stat.Result;
+						out.BestStart = static_cast<size_t>(i);
+						Incumbent.store(stat.Result.Val, std::memory_order_relaxed);
+					}
+					out.Starts[i] = std::move(stat);
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock{ m };
+					if (!failure)
+						failure = std::current_exception();
+				}
+			}
+			if (failure)
+				std::rethrow_exception(failure);
+			return out;
+		}
+
+	protected:
+		func* f;
+		OptimizerParams Prm;
+		MultiStartParams MPrm;
+		std::atomic<double> Incumbent{ std::numeric_limits<double>::infinity() };
+
+		StartStatistics<arg_count> RunStart(state& State)
+		{
+			size_t s = 0;
+			bool converged = false;
+			bool cancelled = false;
+			double before = State.Guess().Val; // value at the beginning of the current patience window
+			ValueWindow Window{ Prm, arg_count, before };
+
+			while (!converged && !cancelled && s < Prm.max_iter)
+			{
+				algo::Proceed(State, f);
+				++s;
+				const bool values = Window.Converged(State.Guess().Val);
+				converged = State.IsConverged(Prm.eps_x, Prm.eps_x) && values; // the criteria of Optimizer
+
+				if (MPrm.patience > 0 && s % MPrm.patience == 0)
+				{
+					double now = State.Guess().Val;
+					double gap = now - Incumbent.load(std::memory_order_relaxed);
+					double windows = static_cast<double>(Prm.max_iter - s) / MPrm.patience;
+					cancelled = gap > 0.0 && gap > MPrm.optimism * (before - now) * windows;
+					before = now;
+				}
+			}
+			return StartStatistics<arg_count>{ State.Guess(), s, converged, cancelled };
+		}
+	};
+} // OptLib
+
+#endif
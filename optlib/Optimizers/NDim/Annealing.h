@@ -1,43 +1,357 @@
 #ifndef ANNEALING_H
 #define ANNEALING_H
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "../../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../../Points/SetOfPoints/PointVals/PointValOperators.h"
+
+#include "../../Functions/Interface/FuncInterface.h"
+
+#include "../../States/State.h"
+
+#include "../../Random/Distributions.h"
+
+#include "../AskTell.h"
+
 namespace OptLib
 {
+	namespace ConcreteState
+	{
+		/// @brief How the batch of candidates of one step is turned into a move
+		enum class BatchAcceptance
+		{
+			// the candidates are tested one by one as consecutive steps of the plain annealing,
+			// the first accepted one ends the step and the rest are only used for the best point
+			Sequential,
+			// multiple-try Metropolis: one candidate is selected with a probability proportional to exp(-f/T)
+			// and accepted by the generalized Metropolis ratio, which needs Batch - 1 reference points more
+			MultipleTry
+		};
+
+		/// @brief State of the annealing that proposes Batch candidates per step and evaluates them together
+		template<size_t dim, typename schedule = CoolingSchedule::Geometric>
+		class StateStochasticBatch : public StateStochastic<dim, schedule>
+		{
+		protected:
+			using Base = StateStochastic<dim, schedule>;
+
+		public:
+			constexpr static const char* CheckpointTag = "StochasticBatch";
+			using func_type = typename Base::func_type;
+
+			// number of candidates evaluated together
+			const size_t Batch;
+			const BatchAcceptance Acceptance;
+
+			// buffers of the current batch
+			std::vector<Point<dim>> X;
+			std::vector<double> V;
+			std::vector<double> W; // weights of the multiple-try Metropolis
+			// the trial selected by the multiple-try Metropolis, the shift of its weights and the sum of the weights of the trials
+			PointVal<dim> Selected{};
+			double Shift{ 0.0 };
+			double SumY{ 0.0 };
+
+			StateStochasticBatch(
+				Point<dim>&& State,
+				const func_type* f,
+				double initialTemperature,
+				schedule TemperatureSchedule,
+				double step,
+				double temperature_end,
+				size_t batch,
+				BatchAcceptance acceptance,
+				std::uint64_t seed = 0) :
+				Base{ std::move(State), f, initialTemperature, std::move(TemperatureSchedule), step, temperature_end, seed },
+				Batch{ std::max<size_t>(batch, 1) },
+				Acceptance{ acceptance },
+				X(Batch),
+				V(Batch),
+				W(Batch)
+			{}
+
+			/// @brief Neighbour of an arbitrary point, for the reference points of the multiple-try Metropolis
+			Point<dim> RandomNeighbour(const Point<dim>& center)
+			{
+				return Random::UniformPoint(this->Rng, center, this->h);
+			}
+
+			template<typename archive>
+			void Serialize(archive& ar)
+			{
+				Base::Serialize(ar);
+				ar(Selected, Shift, SumY);
+			}
+		};
+	} // ConcreteState
+
 	namespace ConcreteOptimizer
 	{
+		/// @brief Simulated annealing: one uniform neighbour of the guess per step and the Metropolis test
 		template<size_t dim>
-		class Annealing: OptimizerInterface::OptimizerAlgorithm<dim>{
+		class Annealing
+		{
 		public:
-			static PointVal<dim> Proceed(ConcreteState::StateStochastic<dim>& State, const FuncInterface::IFunc<dim>* f)
+			template<typename schedule>
+			static PointVal<dim> Proceed(ConcreteState::StateStochastic<dim, schedule>& State, const FuncInterface::IFunc<dim>* f)
 			{
-				State.UpdateState();
+				State.UpdateState(FuncInterface::CreateFromPoint<dim>(State.NextRandomState(), f));
 				return State.Guess();
 			}
 		};
-	}
+
+		/// @brief Simulated annealing with Batch candidates per step.
+		/// The candidates are evaluated together by FuncInterface::EvaluateParallel, so an expensive objective keeps all the cores busy
+		template<size_t dim>
+		class BatchAnnealing
+		{
+		public:
+			template<typename schedule>
+			static PointVal<dim> Proceed(ConcreteState::StateStochasticBatch<dim, schedule>& State, const FuncInterface::IFunc<dim>* f)
+			{
+				Trials(State);
+				FuncInterface::EvaluateParallel<dim>(f, State.X.data(), State.V.data(), State.Batch);
+				if (IsMultipleTry(State))
+				{
+					Select(State);
+					FuncInterface::EvaluateParallel<dim>(f, State.X.data(), State.V.data(), State.Batch - 1);
+					AcceptTry(State);
+				}
+				else
+					Sequential(State);
+				return State.Guess();
+			}
+
+			template<typename schedule>
+			static bool IsMultipleTry(const ConcreteState::StateStochasticBatch<dim, schedule>& State)
+			{
+				return State.Acceptance == ConcreteState::BatchAcceptance::MultipleTry && State.Batch > 1;
+			}
+
+			/// @brief Draws the Batch candidates of a step to X
+			template<typename schedule>
+			static void Trials(ConcreteState::StateStochasticBatch<dim, schedule>& State)
+			{
+				if (IsMultipleTry(State))
+					State.CoolDown(); // the whole batch is one step of the multiple-try Metropolis
+				for (size_t i = 0; i < State.Batch; ++i)
+					State.X[i] = State.NextRandomState();
+			}
+
+			/// @brief Speculative execution of Batch steps of the plain annealing on the evaluated candidates.
+			/// All the candidates are neighbours of the same guess, which is exactly what the plain annealing
+			/// would propose until the first acceptance
+			template<typename schedule>
+			static void Sequential(ConcreteState::StateStochasticBatch<dim, schedule>& State)
+			{
+				const size_t B = State.Batch;
+				bool moved = false;
+				for (size_t i = 0; i < B; ++i)
+				{
+					PointVal<dim> y{ State.X[i], State.V[i] };
+					if (!moved)
+					{
+						State.CoolDown();
+						if (State.Accept(y.Val))
+						{
+							State.ChangeGuess(y);
+							moved = true;
+						}
+					}
+					if (y < State.bestGuess) State.bestGuess = y;
+				}
+			}
+
+			/// @brief The first half of a step of the multiple-try Metropolis with the weights exp(-f/T) (Liu, Liang, Wong, 2000)
+			/// on the evaluated candidates: selects one of them and draws Batch - 1 reference points around it to X
+			template<typename schedule>
+			static void Select(ConcreteState::StateStochasticBatch<dim, schedule>& State)
+			{
+				const size_t B = State.Batch;
+				const double T = State.temperature;
+
+				// the weights are shifted by the best value of the trials, which cancels in all the ratios
+				const double ref = *std::min_element(State.V.begin(), State.V.end());
+				auto& w = State.W;
+				double sumY = 0.0;
+				for (size_t i = 0; i < B; ++i)
+				{
+					w[i] = std::exp(-(State.V[i] - ref) / T);
+					sumY += w[i];
+				}
+
+				size_t sel = B - 1;
+				double u = State.Rng.Uniform() * sumY;
+				for (size_t i = 0; i < B; ++i)
+				{
+					if (u < w[i]) { sel = i; break; }
+					u -= w[i];
+				}
+				State.Selected = PointVal<dim>{ State.X[sel], State.V[sel] };
+				State.Shift = ref;
+				State.SumY = sumY;
+				for (size_t i = 0; i < B; ++i)
+					if (PointVal<dim> t{ State.X[i], State.V[i] }; t < State.bestGuess) State.bestGuess = t;
+
+				// reference set: Batch - 1 neighbours of the selected trial and the current guess
+				for (size_t i = 0; i + 1 < B; ++i)
+					State.X[i] = State.RandomNeighbour(State.Selected.P);
+			}
+
+			/// @brief The second half: the proposal is symmetric, so the selected trial is accepted by the ratio
+			/// sum w(y_j) / sum w(x_j) with the evaluated reference points
+			template<typename schedule>
+			static void AcceptTry(ConcreteState::StateStochasticBatch<dim, schedule>& State)
+			{
+				const size_t B = State.Batch;
+				const double T = State.temperature;
+				const double ref = State.Shift;
+				const double sumY = State.SumY;
+
+				double sumX = std::exp(-(State.Guess().Val - ref) / T);
+				for (size_t i = 0; i + 1 < B; ++i)
+				{
+					sumX += std::exp(-(State.V[i] - ref) / T);
+					if (PointVal<dim> t{ State.X[i], State.V[i] }; t < State.bestGuess) State.bestGuess = t;
+				}
+
+				bool accepted = sumY >= sumX || State.Rng.Uniform() * sumX < sumY;
+				State.Observe(accepted);
+				if (accepted)
+					State.ChangeGuess(State.Selected);
+			}
+		};
+	} // ConcreteOptimizer
+
 	namespace StateParams
 	{
-		template<size_t dim>
+		/// @tparam schedule Cooling schedule, see CoolingSchedule.h
+		template<size_t dim, typename schedule = CoolingSchedule::Geometric>
 		struct AnnealingParams
 		{
 		protected:
 			double h;
 			double endTemperature;
 			double initialTemperature;
-			double (*TemperatureFunction) (double, int);
-			Point<dim> currentPoint;
+			schedule TemperatureSchedule;
+			std::uint64_t seed;
 		public:
+			Point<dim> currentPoint;
 			using OptAlgo = OptLib::ConcreteOptimizer::Annealing<dim>;
-			using StateType = OptLib::ConcreteState::StateStochastic<dim>;
-			AnnealingParams(Point<dim>&& sop, double step, double temperature_end) :
-				h{ step }, endTemperature{ temperature_end }, currentPoint{ std::move(sop) } {}
+			using StateType = OptLib::ConcreteState::StateStochastic<dim, schedule>;
+			AnnealingParams(Point<dim>&& sop, double step, double temperature_start, double temperature_end,
+				schedule sch = {}, std::uint64_t seed = 0) :
+				h{ step }, endTemperature{ temperature_end }, initialTemperature{ temperature_start },
+				TemperatureSchedule{ std::move(sch) }, seed{ seed }, currentPoint{ std::move(sop) } {}
 			StateType CreateState(FuncInterface::IFunc<dim>* f)
 			{
-				state = new StateStochastic<dim>(std::move(currentPoint), f, initialTemperature, TemperatureFunction);
-				return state;
+				return { std::move(currentPoint), f, initialTemperature, TemperatureSchedule, h, endTemperature, seed };
+			}
+		};
+
+		/// @tparam schedule Cooling schedule, see CoolingSchedule.h
+		template<size_t dim, typename schedule = CoolingSchedule::Geometric>
+		struct BatchAnnealingParams
+		{
+		protected:
+			double h;
+			double endTemperature;
+			double initialTemperature;
+			schedule TemperatureSchedule;
+			size_t batch;
+			ConcreteState::BatchAcceptance acceptance;
+			std::uint64_t seed;
+		public:
+			Point<dim> currentPoint;
+			using OptAlgo = OptLib::ConcreteOptimizer::BatchAnnealing<dim>;
+			using StateType = OptLib::ConcreteState::StateStochasticBatch<dim, schedule>;
+			BatchAnnealingParams(Point<dim>&& sop, double step, double temperature_start, double temperature_end,
+				schedule sch, size_t batch,
+				ConcreteState::BatchAcceptance acceptance = ConcreteState::BatchAcceptance::Sequential, std::uint64_t seed = 0) :
+				h{ step }, endTemperature{ temperature_end }, initialTemperature{ temperature_start },
+				TemperatureSchedule{ std::move(sch) }, batch{ batch }, acceptance{ acceptance }, seed{ seed },
+				currentPoint{ std::move(sop) } {}
+			StateType CreateState(FuncInterface::IFunc<dim>* f)
+			{
+				return { std::move(currentPoint), f, initialTemperature, TemperatureSchedule, h, endTemperature, batch, acceptance, seed };
 			}
 		};
 	}
+
+	namespace ConcreteOptimizer
+	{
+		/// @brief Simulated annealing as an ask/tell state machine, see OptimizerInterface::AskTell. Every step asks for one neighbour
+		template<size_t dim, typename schedule = CoolingSchedule::Geometric>
+		class AnnealingAskTell : public OptimizerInterface::AskTell<AnnealingAskTell<dim, schedule>, StateParams::AnnealingParams<dim, schedule>>
+		{
+			using Base = OptimizerInterface::AskTell<AnnealingAskTell<dim, schedule>, StateParams::AnnealingParams<dim, schedule>>;
+			friend Base;
+
+		public:
+			using Base::Base;
+
+		protected:
+			void Propose(std::vector<Point<dim>>& out)
+			{
+				out.push_back(this->ItsState->NextRandomState());
+			}
+
+			void Complete(const double* v)
+			{
+				this->ItsState->UpdateState(PointVal<dim>{ this->Asked[0], v[0] });
+			}
+		};
+
+		/// @brief Batch annealing as an ask/tell state machine, see OptimizerInterface::AskTell. A step asks for the Batch candidates
+		/// and, with the multiple-try Metropolis, for the Batch - 1 reference points next
+		template<size_t dim, typename schedule = CoolingSchedule::Geometric>
+		class BatchAnnealingAskTell : public OptimizerInterface::AskTell<BatchAnnealingAskTell<dim, schedule>, StateParams::BatchAnnealingParams<dim, schedule>>
+		{
+			using Base = OptimizerInterface::AskTell<BatchAnnealingAskTell<dim, schedule>, StateParams::BatchAnnealingParams<dim, schedule>>;
+			using Algo = BatchAnnealing<dim>;
+			friend Base;
+
+		public:
+			using Base::Base;
+
+		protected:
+			// the reference points of the multiple-try Metropolis are asked
+			bool References{ false };
+
+			void Propose(std::vector<Point<dim>>& out)
+			{
+				auto& State = *this->ItsState;
+				if (!References)
+					Algo::Trials(State);
+				const size_t n = References ? State.Batch - 1 : State.Batch;
+				out.assign(State.X.begin(), State.X.begin() + n);
+			}
+
+			void Complete(const double* v)
+			{
+				auto& State = *this->ItsState;
+				std::copy(v, v + this->Asked.size(), State.V.begin());
+				if (References)
+				{
+					Algo::AcceptTry(State);
+					References = false;
+				}
+				else if (Algo::IsMultipleTry(State))
+				{
+					Algo::Select(State);
+					References = true;
+				}
+				else
+					Algo::Sequential(State);
+			}
+		};
+	} // ConcreteOptimizer
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,280 @@
+#ifndef CMAES_H
+#define CMAES_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "../../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../../Points/SetOfPoints/PointVals/PointValOperators.h"
+
+#include "../../Functions/Interface/FuncInterface.h"
+
+#include "../../States/StateInterface.h"
+
+#include "../../Random/Distributions.h"
+
+#include "../AskTell.h"
+
+namespace OptLib
+{
+	namespace ConcreteState
+	{
+		/// @brief State of the CMA-ES: the search distribution N(Mean, Sigma^2 C) with C = B D^2 B^T,
+		/// the evolution paths and the strategy constants of (Hansen, 2016, "The CMA evolution strategy: a tutorial").
+		/// The guess is the mean of the distribution the last generation was drawn from, evaluated together with the offspring.
+		/// Unlike the best offspring, it is not biased towards lucky draws on noisy objectives
+		template<size_t dim>
+		class StateCMAES : public StateInterface::IState<dim>
+		{
+		protected:
+			using Base = StateInterface::IState<dim>;
+			using Base::ItsGuess;
+
+			using vector_type = Eigen::VectorXd;
+			using matrix_type = Eigen::MatrixXd;
+
+		public:
+			constexpr static const char* CheckpointTag = "CMAES";
+			using func_type = FuncInterface::IFunc<dim>;
+			using Base::Guess;
+
+			// offspring per generation
+			const size_t Lambda;
+			// parents of the recombination
+			const size_t Mu;
+
+			vector_type Weights;
+			double MuEff;
+			double cc, cs, c1, cmu, damps, chiN;
+
+			vector_type Mean;
+			double Sigma;
+			vector_type pc, ps;
+			matrix_type C;
+			matrix_type B; // eigenvectors of C
+			vector_type D; // square roots of the eigenvalues of C
+			matrix_type InvSqrtC; // B D^-1 B^T
+
+			size_t Generation{ 0 };
+			size_t EigenGeneration{ 0 }; // the generation of the last decomposition of C
+			// C is decomposed once in LazyGap generations, which keeps the O(dim^3) cost per generation at O(dim^2)
+			size_t LazyGap{ 1 };
+
+			Random::Philox4x32 Rng;
+
+			// the best offspring evaluated so far
+			PointVal<dim> Best;
+
+			// buffers of a generation: standard normal samples, their images B D z and the offspring followed by the mean
+			matrix_type Z;
+			matrix_type Y;
+			matrix_type Ysel; // the Mu best columns of Y
+			std::vector<Point<dim>> X;
+			std::vector<double> V;
+			std::vector<size_t> Rank;
+
+			/// @param sigma0 Initial step size, about a quarter of the search range
+			/// @param lambda Offspring per generation, 0 selects the default 4 + 3 ln(dim)
+			StateCMAES(Point<dim>&& x0, const func_type* f, double sigma0, size_t lambda, std::uint64_t seed) :
+				Base{ FuncInterface::CreateFromPoint<dim>(std::move(x0), f) },
+				Lambda{ lambda > 1 ? lambda : 4 + static_cast<size_t>(3.0 * std::log(static_cast<double>(dim))) },
+				Mu{ Lambda / 2 },
+				Sigma{ sigma0 },
+				Rng{ seed },
+				Z(dim, Lambda),
+				Y(dim, Lambda),
+				Ysel(dim, Mu),
+				X(Lambda + 1),
+				V(Lambda + 1),
+				Rank(Lambda)
+			{
+				const double n = static_cast<double>(dim);
+
+				Weights.resize(Mu);
+				for (size_t i = 0; i < Mu; ++i)
+					Weights[i] = std::log(static_cast<double>(Mu) + 0.5) - std::log(static_cast<double>(i + 1));
+				Weights /= Weights.sum();
+				MuEff = 1.0 / Weights.squaredNorm();
+
+				cc = (4.0 + MuEff / n) / (n + 4.0 + 2.0 * MuEff / n);
+				cs = (MuEff + 2.0) / (n + MuEff + 5.0);
+				c1 = 2.0 / ((n + 1.3) * (n + 1.3) + MuEff);
+				cmu = std::min(1.0 - c1, 2.0 * (MuEff - 2.0 + 1.0 / MuEff) / ((n + 2.0) * (n + 2.0) + MuEff));
+				damps = 1.0 + 2.0 * std::max(0.0, std::sqrt((MuEff - 1.0) / (n + 1.0)) - 1.0) + cs;
+				chiN = std::sqrt(n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+				LazyGap = std::max<size_t>(1, static_cast<size_t>(1.0 / ((c1 + cmu) * n * 10.0)));
+
+				Best = Guess();
+				Mean.resize(dim);
+				for (size_t i = 0; i < dim; ++i)
+					Mean[i] = Guess()[i];
+				pc = vector_type::Zero(dim);
+				ps = vector_type::Zero(dim);
+				C = matrix_type::Identity(dim, dim);
+				B = matrix_type::Identity(dim, dim);
+				D = vector_type::Ones(dim);
+				InvSqrtC = matrix_type::Identity(dim, dim);
+			}
+
+			/// @brief The step along every axis, sigma sqrt(C_ii), is below the tolerance
+			bool IsConverged(double abs_tol, double rel_tol) const override
+			{
+				if (Generation == 0) return false;
+				for (size_t i = 0; i < dim; ++i)
+				{
+					double s = Sigma * std::sqrt(C(i, i));
+					bool f = (s < abs_tol) || (s < rel_tol * std::abs(Mean[i]));
+					if (!f) return false;
+				}
+				return true;
+			}
+
+			/// @brief Draws the offspring of a generation: x_k = Mean + Sigma B D z_k, and appends the mean to be evaluated with them
+			void Sample()
+			{
+				Random::FillNormal(Rng, Z.data(), static_cast<size_t>(Z.size()));
+				Y.noalias() = B * D.asDiagonal() * Z;
+				for (size_t k = 0; k < Lambda; ++k)
+					for (size_t i = 0; i < dim; ++i)
+						X[k][i] = Mean[i] + Sigma * Y(i, k);
+				for (size_t i = 0; i < dim; ++i)
+					X[Lambda][i] = Mean[i];
+			}
+
+			/// @brief Selection, recombination and adaptation of the distribution after the offspring are evaluated
+			void UpdateState()
+			{
+				std::iota(Rank.begin(), Rank.end(), size_t{ 0 });
+				std::stable_sort(Rank.begin(), Rank.end(), [this](size_t a, size_t b) { return V[a] < V[b]; });
+
+				if (V[Rank[0]] < Best.Val)
+					Best = PointVal<dim>{ X[Rank[0]], V[Rank[0]] };
+				ItsGuess = PointVal<dim>{ X[Lambda], V[Lambda] };
+
+				for (size_t i = 0; i < Mu; ++i)
+					Ysel.col(i) = Y.col(Rank[i]);
+				vector_type yw = Ysel * Weights;
+				Mean += Sigma * yw;
+
+				++Generation;
+				const double n = static_cast<double>(dim);
+				ps = (1.0 - cs) * ps + std::sqrt(cs * (2.0 - cs) * MuEff) * (InvSqrtC * yw);
+				const double psNorm = ps.norm();
+				const bool hsig = psNorm / std::sqrt(1.0 - std::pow(1.0 - cs, 2.0 * static_cast<double>(Generation))) / chiN
+					< 1.4 + 2.0 / (n + 1.0);
+				pc = (1.0 - cc) * pc + (hsig ? std::sqrt(cc * (2.0 - cc) * MuEff) : 0.0) * yw;
+
+				// rank-one and rank-mu updates
+				const double oldC = 1.0 - c1 - cmu + (hsig ? 0.0 : c1 * cc * (2.0 - cc));
+				C *= oldC;
+				C.noalias() += c1 * pc * pc.transpose();
+				C.noalias() += cmu * Ysel * Weights.asDiagonal() * Ysel.transpose();
+
+				Sigma *= std::exp((cs / damps) * (psNorm / chiN - 1.0));
+
+				if (Generation - EigenGeneration >= LazyGap)
+					Decompose();
+			}
+
+			/// @brief The distribution and the generator. The constants follow from Lambda, the buffers are refilled by Sample
+			template<typename archive>
+			void Serialize(archive& ar)
+			{
+				Base::Serialize(ar);
+				ar(Best, Mean, Sigma, pc, ps, C, B, D, InvSqrtC, Generation, EigenGeneration, Rng);
+			}
+
+		protected:
+			void Decompose()
+			{
+				EigenGeneration = Generation;
+				Eigen::SelfAdjointEigenSolver<matrix_type> es(C); // only the lower triangle is read
+				D = es.eigenvalues().cwiseMax(1E-300).cwiseSqrt();
+				B = es.eigenvectors();
+				InvSqrtC.noalias() = B * D.cwiseInverse().asDiagonal() * B.transpose();
+			}
+		};
+	} // ConcreteState
+
+	namespace ConcreteOptimizer
+	{
+		/// @brief Covariance matrix adaptation evolution strategy, (mu/mu_w, lambda)-CMA-ES.
+		/// A generation samples Lambda offspring and evaluates them with the mean by FuncInterface::EvaluateParallel,
+		/// so a generation costs about one evaluation of wall time when there are Lambda cores
+		template<size_t dim>
+		class CMAES
+		{
+		public:
+			static PointVal<dim> Proceed(ConcreteState::StateCMAES<dim>& State, const FuncInterface::IFunc<dim>* f)
+			{
+				State.Sample();
+				FuncInterface::EvaluateParallel<dim>(f, State.X.data(), State.V.data(), State.Lambda + 1);
+				State.UpdateState();
+				return State.Guess();
+			}
+		};
+	} // ConcreteOptimizer
+
+	namespace StateParams
+	{
+		template<size_t dim>
+		struct CMAESParams
+		{
+		public:
+			using OptAlgo = OptLib::ConcreteOptimizer::CMAES<dim>;
+			using StateType = ConcreteState::StateCMAES<dim>;
+
+		public:
+			Point<dim> StartPoint;
+			CMAESParams(Point<dim>&& sop, double sigma0, size_t lambda = 0, std::uint64_t seed = 0)
+				:StartPoint{ std::move(sop) }, sigma0{ sigma0 }, lambda{ lambda }, seed{ seed }
+			{}
+			StateType CreateState(FuncInterface::IFunc<dim>* f)
+			{
+				return { std::move(StartPoint), f, sigma0, lambda, seed };
+			}
+
+		protected:
+			double sigma0;
+			size_t lambda;
+			std::uint64_t seed;
+		};
+	} // StateParams
+
+	namespace ConcreteOptimizer
+	{
+		/// @brief CMA-ES as an ask/tell state machine, see OptimizerInterface::AskTell. Every generation asks for the Lambda offspring and the mean
+		template<size_t dim>
+		class CMAESAskTell : public OptimizerInterface::AskTell<CMAESAskTell<dim>, StateParams::CMAESParams<dim>>
+		{
+			using Base = OptimizerInterface::AskTell<CMAESAskTell<dim>, StateParams::CMAESParams<dim>>;
+			friend Base;
+
+		public:
+			using Base::Base;
+
+		protected:
+			void Propose(std::vector<Point<dim>>& out)
+			{
+				auto& State = *this->ItsState;
+				State.Sample();
+				out = State.X;
+			}
+
+			void Complete(const double* v)
+			{
+				auto& State = *this->ItsState;
+				std::copy(v, v + State.Lambda + 1, State.V.begin());
+				State.UpdateState();
+			}
+		};
+	} // ConcreteOptimizer
+} // OptLib
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef CONJUGATEGRADIENT_H
+#define CONJUGATEGRADIENT_H
+
+#include <algorithm>
+
+#include "SteepestDescent.h"
+
+namespace OptLib
+{
+	namespace ConcreteState
+	{
+		/// @brief Adds the current search direction to StateGradient
+		template<size_t dim>
+		class StateConjugateGradient : public StateGradient<dim>
+		{
+		protected:
+			using Base = StateGradient<dim>;
+
+			Point<dim> ItsDirection;
+			size_t SinceRestart{ 0 };
+
+		public:
+			constexpr static const char* CheckpointTag = "ConjugateGradient";
+			StateConjugateGradient(Point<dim>&& x0, const typename Base::func_type* f, double step0, size_t lineIter, double lineTol) :
+				Base{ std::move(x0), f, step0, lineIter, lineTol },
+				ItsDirection{ -1.0 * this->Gradient() }
+			{}
+
+			const Point<dim>& Direction() const { return ItsDirection; }
+			/// @brief Number of directions built since the last restart with the antigradient
+			size_t IterSinceRestart() const { return SinceRestart; }
+
+			void SetDirection(Point<dim>&& d, bool restarted)
+			{
+				ItsDirection = std::move(d);
+				SinceRestart = restarted ? 0 : SinceRestart + 1;
+			}
+
+			template<typename archive>
+			void Serialize(archive& ar)
+			{
+				Base::Serialize(ar);
+				ar(ItsDirection, SinceRestart);
+			}
+		};
+	} // ConcreteState
+
+	namespace ConcreteOptimizer
+	{
+		/// @brief beta = (g1, g1) / (g0, g0)
+		struct FletcherReeves
+		{
+			template<size_t dim>
+			static double Beta(const Grad<dim>& g1, const Grad<dim>& g0)
+			{
+				return dot_product(g1, g1) / dot_product(g0, g0);
+			}
+		};
+
+		/// @brief beta = max{(g1, g1 - g0) / (g0, g0), 0}, i.e., PR+ with an automatic restart
+		struct PolakRibiere
+		{
+			template<size_t dim>
+			static double Beta(const Grad<dim>& g1, const Grad<dim>& g0)
+			{
+				return std::max(dot_product(g1, g1 - g0) / dot_product(g0, g0), 0.0);
+			}
+		};
+
+		/// @brief Nonlinear conjugate gradients with the step chosen by a 1D method along FuncAlongDirection.
+		/// The method is restarted with the antigradient every dim iterations or if the direction is not a descent one
+		/// @tparam betaRule FletcherReeves or PolakRibiere
+		/// @tparam lineParams Parameters of the 1D method used as a line search
+		template<size_t dim, typename betaRule = PolakRibiere, typename lineParams = StateParams::GoldenSectionParams>
+		class ConjugateGradient
+		{
+		public:
+			static PointVal<dim> Proceed(ConcreteState::StateConjugateGradient<dim>& State, const FuncInterface::IFuncWithGrad<dim>* f)
+			{
+				const PointVal<dim> x{ State.Guess() };
+				ConcreteFunc::FuncAlongDirection<dim> phi{ f, x.P, State.Direction() };
+
+				PointVal<1> best{ LineSearch<lineParams>::Search(
+					&phi, PointVal<1>{ Point<1>{ 0.0 }, x.Val }, 2.0 * State.Step(), State.LineIter, State.LineTol) };
+
+				if (!(best.Val < x.Val))
+				{
+					if (State.IterSinceRestart() == 0)
+						State.UpdateState(x); // the antigradient failed, dx == 0 means convergence
+					else
+						State.SetDirection(-1.0 * State.Gradient(), true);
+					return State.Guess();
+				}
+
+				Point<dim> xNew{ phi.PointAt(best.P[0]) };
+				Grad<dim> g{ f->grad(xNew) };
+
+				bool restart{ State.IterSinceRestart() + 1 >= dim };
+				Point<dim> d{ -1.0 * g };
+				if (!restart)
+				{
+					d = d + State.Direction() * betaRule::Beta(g, State.Gradient());
+					restart = !(dot_product(d, g) < 0.0);
+					if (restart)
+						d = -1.0 * g;
+				}
+
+				State.UpdateState(PointVal<dim>{ std::move(xNew), best.Val }, std::move(g), best.P[0]);
+				State.SetDirection(std::move(d), restart);
+				return State.Guess();
+			}
+		};
+	} // ConcreteOptimizer
+
+	namespace StateParams
+	{
+		template<size_t dim, typename betaRule = ConcreteOptimizer::PolakRibiere, typename lineParams = GoldenSectionParams>
+		struct ConjugateGradientParams
+		{
+		public:
+			using OptAlgo = OptLib::ConcreteOptimizer::ConjugateGradient<dim, betaRule, lineParams>;
+			using StateType = ConcreteState::StateConjugateGradient<dim>;
+
+		public:
+			Point<dim> StartPoint;
+			ConjugateGradientParams(Point<dim>&& sop, double step0 = 1.0E-2, size_t lineIter = 40, double lineTol = 1.0E-10)
+				:StartPoint{ std::move(sop) }, step0{ step0 }, lineIter{ lineIter }, lineTol{ lineTol }
+			{}
+			StateType CreateState(FuncInterface::IFuncWithGrad<dim>* f)
+			{
+				return { std::move(StartPoint), f, step0, lineIter, lineTol };
+			}
+
+		protected:
+			double step0;
+			size_t lineIter;
+			double lineTol;
+		};
+	} // StateParams
+} // OptLib
+
+#endif
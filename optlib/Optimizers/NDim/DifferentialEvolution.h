@@ -0,0 +1,237 @@
+#ifndef DIFFERENTIALEVOLUTION_H
+#define DIFFERENTIALEVOLUTION_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "../../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../../Points/SetOfPoints/Population.h"
+#include "../../Points/SetOfPoints/Selection.h"
+
+#include "../../Functions/Interface/FuncInterface.h"
+
+#include "../../States/StatePopulation.h"
+
+#include "../../Random/Distributions.h"
+
+#include "../AskTell.h"
+
+namespace OptLib
+{
+	namespace ConcreteState
+	{
+		/// @brief Mutation of the differential evolution
+		enum class DEStrategy
+		{
+			// v = x_r1 + F (x_r2 - x_r3)
+			Rand1Bin,
+			// v = x + F (x_best - x) + F (x_r1 - x_r2), faster on unimodal functions, less robust on multimodal ones
+			CurrentToBest1Bin
+		};
+
+		/// @brief State of the differential evolution: the population, the trial population and the buffers of a generation
+		template<size_t dim>
+		class StateDifferentialEvolution : public StateInterface::StatePopulation<dim>
+		{
+		protected:
+			using Base = StateInterface::StatePopulation<dim>;
+
+		public:
+			constexpr static const char* CheckpointTag = "DifferentialEvolution";
+			using func_type = typename Base::func_type;
+
+			// differential weight
+			const double F;
+			// crossover probability
+			const double CR;
+			const DEStrategy Strategy;
+
+			Population<dim> Trial;
+			std::vector<double> FTrial;
+			// donors of every individual and the axis always taken from the mutant
+			std::vector<std::uint32_t> R1, R2, R3, JRand;
+			// random bits of the crossover, laid out as the population
+			std::vector<std::uint32_t> U;
+
+			StateDifferentialEvolution(Point<dim>&& lower, Point<dim>&& upper, const func_type* f, size_t size,
+				double F, double CR, DEStrategy strategy, std::uint64_t seed) :
+				Base{ std::move(lower), std::move(upper), f, size, seed },
+				F{ F }, CR{ CR }, Strategy{ strategy },
+				Trial(this->Size()), FTrial(this->Size()),
+				R1(this->Size()), R2(this->Size()), R3(this->Size()), JRand(this->Size()),
+				U(dim * this->Size())
+			{}
+
+			/// @brief Draws three donors distinct from each other and from the target for every individual
+			void DrawDonors()
+			{
+				const size_t n = this->Size();
+				for (size_t k = 0; k < n; ++k)
+				{
+					std::uint32_t a, b, c;
+					do a = this->Index(n); while (a == k);
+					do b = this->Index(n); while (b == k || b == a);
+					do c = this->Index(n); while (c == k || c == a || c == b);
+					R1[k] = a; R2[k] = b; R3[k] = c;
+					JRand[k] = this->Index(dim);
+				}
+				Random::FillBits32(this->Rng, U.data(), U.size());
+			}
+		};
+	} // ConcreteState
+
+	namespace ConcreteOptimizer
+	{
+		/// @brief Differential evolution (Storn, Price, 1997) with the binomial crossover.
+		/// The mutation, the crossover and the selection run along one axis of the column-major population
+		/// at a time and vectorize. The trial population is evaluated as one batch by FuncInterface::EvaluateParallel
+		template<size_t dim>
+		class DifferentialEvolution
+		{
+		public:
+			static PointVal<dim> Proceed(ConcreteState::StateDifferentialEvolution<dim>& State, const FuncInterface::IFunc<dim>* f)
+			{
+				Propose(State);
+				State.Evaluate(f, State.Trial, State.FTrial.data());
+				return Select(State);
+			}
+
+			/// @brief Mutation and crossover: fills the trial population
+			static void Propose(ConcreteState::StateDifferentialEvolution<dim>& State)
+			{
+				const size_t n = State.Size();
+				const double F = State.F;
+				// u < CR for a uniform u is the same as bits < CR 2^32 for 32 random bits
+				const std::uint64_t CR = static_cast<std::uint64_t>(State.CR * 0x1.0p32);
+				const std::uint32_t* r1 = State.R1.data();
+				const std::uint32_t* r2 = State.R2.data();
+				const std::uint32_t* r3 = State.R3.data();
+				const std::uint32_t* jr = State.JRand.data();
+
+				State.DrawDonors();
+				const size_t best = Selection::ArgMin(State.FX.data(), n);
+
+				for (size_t i = 0; i < dim; ++i)
+				{
+					const double* x = State.X.Axis(i);
+					double* t = State.Trial.Axis(i);
+					const std::uint32_t* u = State.U.data() + i * n;
+					const std::uint32_t axis = static_cast<std::uint32_t>(i);
+
+					if (State.Strategy == ConcreteState::DEStrategy::Rand1Bin)
+					{
+#pragma omp simd
+						for (size_t k = 0; k < n; ++k)
+							t[k] = x[r1[k]] + F * (x[r2[k]] - x[r3[k]]);
+					}
+					else
+					{
+						const double xb = x[best];
+#pragma omp simd
+						for (size_t k = 0; k < n; ++k)
+							t[k] = x[k] + F * (xb - x[k]) + F * (x[r1[k]] - x[r2[k]]);
+					}
+					State.Clamp(i, t, n);
+#pragma omp simd
+					for (size_t k = 0; k < n; ++k)
+					{
+						const bool c = (u[k] < CR) | (jr[k] == axis); // no short circuit, it would be a branch
+						const double tk = t[k];
+						const double xk = x[k];
+						t[k] = c ? tk : xk;
+					}
+				}
+
+			}
+
+			/// @brief Selection after the trial population is evaluated: the trial replaces the target if it is not worse
+			static PointVal<dim> Select(ConcreteState::StateDifferentialEvolution<dim>& State)
+			{
+				const size_t n = State.Size();
+				const double* ft = State.FTrial.data();
+				double* fx = State.FX.data();
+				for (size_t i = 0; i < dim; ++i)
+				{
+					double* x = State.X.Axis(i);
+					const double* t = State.Trial.Axis(i);
+#pragma omp simd
+					for (size_t k = 0; k < n; ++k)
+					{
+						const double tk = t[k];
+						const double xk = x[k];
+						x[k] = ft[k] <= fx[k] ? tk : xk;
+					}
+				}
+#pragma omp simd
+				for (size_t k = 0; k < n; ++k)
+					fx[k] = ft[k] <= fx[k] ? ft[k] : fx[k];
+
+				State.UpdateState(State.X, State.FX);
+				return State.Guess();
+			}
+		};
+	} // ConcreteOptimizer
+
+	namespace StateParams
+	{
+		template<size_t dim>
+		struct DifferentialEvolutionParams
+		{
+		public:
+			using OptAlgo = OptLib::ConcreteOptimizer::DifferentialEvolution<dim>;
+			using StateType = ConcreteState::StateDifferentialEvolution<dim>;
+
+		public:
+			Point<dim> Lower;
+			Point<dim> Upper;
+			DifferentialEvolutionParams(Point<dim>&& lower, Point<dim>&& upper, size_t size, double F = 0.5, double CR = 0.9,
+				ConcreteState::DEStrategy strategy = ConcreteState::DEStrategy::Rand1Bin, std::uint64_t seed = 0)
+				:Lower{ std::move(lower) }, Upper{ std::move(upper) }, size{ size }, F{ F }, CR{ CR }, strategy{ strategy }, seed{ seed }
+			{}
+			StateType CreateState(FuncInterface::IFunc<dim>* f)
+			{
+				return { std::move(Lower), std::move(Upper), f, size, F, CR, strategy, seed };
+			}
+
+		protected:
+			size_t size;
+			double F;
+			double CR;
+			ConcreteState::DEStrategy strategy;
+			std::uint64_t seed;
+		};
+	} // StateParams
+
+	namespace ConcreteOptimizer
+	{
+		/// @brief Differential evolution as an ask/tell state machine, see OptimizerInterface::AskTell. Every generation asks for the trial population
+		template<size_t dim>
+		class DifferentialEvolutionAskTell : public OptimizerInterface::AskTell<DifferentialEvolutionAskTell<dim>, StateParams::DifferentialEvolutionParams<dim>>
+		{
+			using Base = OptimizerInterface::AskTell<DifferentialEvolutionAskTell<dim>, StateParams::DifferentialEvolutionParams<dim>>;
+			friend Base;
+
+		public:
+			using Base::Base;
+
+		protected:
+			void Propose(std::vector<Point<dim>>& out)
+			{
+				auto& State = *this->ItsState;
+				DifferentialEvolution<dim>::Propose(State);
+				out = State.Gather(State.Trial);
+			}
+
+			void Complete(const double* v)
+			{
+				auto& State = *this->ItsState;
+				std::copy(v, v + State.Size(), State.FTrial.begin());
+				DifferentialEvolution<dim>::Select(State);
+			}
+		};
+	} // ConcreteOptimizer
+} // OptLib
+
+#endif
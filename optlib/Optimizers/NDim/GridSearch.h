@@ -0,0 +1,266 @@
+#ifndef GRIDSEARCH_H
+#define GRIDSEARCH_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "../../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../../Points/SetOfPoints/PointVals/Point/PointOperators.h"
+#include "../../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../../Points/SetOfPoints/PointVals/PointValOperators.h"
+#include "../../Points/SetOfPoints/Selection.h"
+
+#include "../../Functions/Interface/FuncInterface.h"
+
+#include "../../States/StateInterface.h"
+
+namespace OptLib
+{
+	namespace ConcreteState
+	{
+		/// @brief State of the tensor grid search: the current box [Lower, Upper] and the best node found so far.
+		/// Every iteration scans Nodes^dim nodes of the box
+		template<size_t dim>
+		class StateGridSearch : public StateInterface::IState<dim>
+		{
+		protected:
+			using Base = StateInterface::IState<dim>;
+			using Base::ItsGuess;
+
+			Point<dim> ItsLower;
+			Point<dim> ItsUpper;
+			size_t Level{ 0 };
+
+		public:
+			constexpr static const char* CheckpointTag = "GridSearch";
+			using func_type = FuncInterface::IFunc<dim>;
+			using Base::Guess;
+
+			// nodes per axis including both ends of the box, 2 <= Nodes <= MaxNodes()
+			const size_t Nodes;
+			// number of nodes evaluated by a thread as one batch
+			const size_t TileSize;
+			// if true, the box is shrunk to the cells around the best node after every scan
+			const bool Refine;
+
+			StateGridSearch(Point<dim>&& lower, Point<dim>&& upper, const func_type* f, size_t nodes, bool refine, size_t tileSize) :
+				Base{ FuncInterface::CreateFromPoint<dim>((lower + upper) / 2.0, f) },
+				ItsLower{ std::move(lower) },
+				ItsUpper{ std::move(upper) },
+				Nodes{ std::clamp<size_t>(nodes, 2, MaxNodes()) },
+				TileSize{ std::max<size_t>(tileSize, 1) },
+				Refine{ refine }
+			{}
+
+			/// @brief Whether the n^dim nodes of a scan can be indexed, the OpenMP loop over the tiles takes a signed index
+			static bool Fits(size_t n)
+			{
+				constexpr size_t limit = static_cast<size_t>(std::numeric_limits<long long>::max());
+				size_t total = 1;
+				for (size_t i = 0; i < dim; ++i)
+				{
+					if (total > limit / n) return false;
+					total *= n;
+				}
+				return true;
+			}
+
+			/// @brief The largest number of nodes per axis that Fits, e.g., 8 for dim == 20. A larger number is clamped to it
+			static size_t MaxNodes()
+			{
+				size_t n = static_cast<size_t>(std::pow(2.0, 63.0 / static_cast<double>(dim))); // a guess corrected by the exact test
+				n = std::clamp<size_t>(n, 2, std::numeric_limits<size_t>::max() / 2);
+				while (n > 2 && !Fits(n)) --n;
+				while (Fits(n + 1)) ++n;
+				return n;
+			}
+
+			const Point<dim>& Lower() const { return ItsLower; }
+			const Point<dim>& Upper() const { return ItsUpper; }
+			/// @brief Number of completed scans
+			size_t Scans() const { return Level; }
+
+			/// @brief Distance between neighbouring nodes along every axis
+			Point<dim> CellSize() const
+			{
+				return (ItsUpper - ItsLower) / static_cast<double>(Nodes - 1);
+			}
+
+			bool IsConverged(double abs_tol, double rel_tol) const override
+			{
+				if (Level == 0) return false;
+				if (!Refine) return true; // a single scan is all the method does
+
+				Point<dim> h{ CellSize() };
+				for (size_t i = 0; i < dim; ++i)
+				{
+					bool f = (std::abs(h[i]) < abs_tol) || (std::abs(h[i]) < rel_tol * std::abs(Guess()[i]));
+					if (!f) return false;
+				}
+				return true;
+			}
+
+			/// @brief Accepts the best node of a scan and zooms into its cells if Refine is set
+			void UpdateState(const PointVal<dim>& best)
+			{
+				if (best < ItsGuess)
+					ItsGuess = best;
+
+				if (Refine)
+				{
+					Point<dim> h{ CellSize() };
+					for (size_t i = 0; i < dim; ++i)
+					{
+						ItsLower[i] = std::max(ItsLower[i], ItsGuess[i] - h[i]);
+						ItsUpper[i] = std::min(ItsUpper[i], ItsGuess[i] + h[i]);
+					}
+				}
+				++Level;
+			}
+
+			template<typename archive>
+			void Serialize(archive& ar)
+			{
+				Base::Serialize(ar);
+				ar(ItsLower, ItsUpper, Level);
+			}
+		};
+	} // ConcreteState
+
+	namespace ConcreteOptimizer
+	{
+		/// @brief Brute-force scan of a tensor grid.
+		/// The linear index space of the nodes is split into tiles of TileSize nodes, which are handed out dynamically
+		/// to the OpenMP threads. A thread builds the points of its tile from their indices without loop-carried sums,
+		/// evaluates them through the batch path of IFuncBatch, if f has it, and keeps its own minimum.
+		/// The per-thread minima are reduced once per scan. Ties are broken by the smaller index, so the result
+		/// does not depend on the number of threads. f must be thread-safe
+		template<size_t dim>
+		class GridSearch
+		{
+		public:
+			static PointVal<dim> Proceed(ConcreteState::StateGridSearch<dim>& State, const FuncInterface::IFunc<dim>* f)
+			{
+				const size_t n = State.Nodes;
+				const size_t tile = State.TileSize;
+				const Point<dim> lo{ State.Lower() };
+				const Point<dim> h{ State.CellSize() };
+
+				size_t total = 1; // does not overflow, see StateGridSearch::MaxNodes
+				for (size_t i = 0; i < dim; ++i)
+					total *= n;
+				const size_t tiles = total / tile + (total % tile != 0);
+
+				double bestVal = std::numeric_limits<double>::infinity();
+				size_t bestIdx = total;
+
+#pragma omp parallel
+				{
+					std::vector<Point<dim>> x(std::min(tile, total));
+					std::vector<double> v(x.size());
+					double myVal = std::numeric_limits<double>::infinity();
+					size_t myIdx = total;
+
+#pragma omp for schedule(dynamic, 1) nowait
+					for (long long t = 0; t < static_cast<long long>(tiles); ++t)
+					{
+						const size_t begin = static_cast<size_t>(t) * tile;
+						const size_t count = std::min(tile, total - begin);
+
+						std::array<size_t, dim> idx{ Decode(begin, n) };
+						for (size_t k = 0; k < count; ++k)
+						{
+							for (size_t i = 0; i < dim; ++i)
+								x[k][i] = lo[i] + static_cast<double>(idx[i]) * h[i];
+							Next(idx, n);
+						}
+
+						FuncInterface::EvaluateBatch<dim>(f, x.data(), v.data(), count);
+
+						size_t k = Selection::ArgMin(v.data(), count);
+						if (v[k] < myVal || (v[k] == myVal && begin + k < myIdx))
+						{
+							myVal = v[k];
+							myIdx = begin + k;
+						}
+					}
+
+#pragma omp critical
+					if (myVal < bestVal || (myVal == bestVal && myIdx < bestIdx))
+					{
+						bestVal = myVal;
+						bestIdx = myIdx;
+					}
+				}
+
+				if (bestIdx < total)
+				{ // otherwise f is NaN everywhere and the guess is kept
+					std::array<size_t, dim> idx{ Decode(bestIdx, n) };
+					PointVal<dim> best;
+					for (size_t i = 0; i < dim; ++i)
+						best[i] = lo[i] + static_cast<double>(idx[i]) * h[i];
+					best.Val = bestVal;
+					State.UpdateState(best);
+				}
+				else
+					State.UpdateState(State.Guess());
+				return State.Guess();
+			}
+
+		protected:
+			/// @brief Multi-index of the linear index, the first axis runs fastest
+			static std::array<size_t, dim> Decode(size_t linear, size_t n)
+			{
+				std::array<size_t, dim> idx;
+				for (size_t i = 0; i < dim; ++i)
+				{
+					idx[i] = linear % n;
+					linear /= n;
+				}
+				return idx;
+			}
+
+			/// @brief Odometer increment of the multi-index, which avoids divisions in the inner loop
+			static void Next(std::array<size_t, dim>& idx, size_t n)
+			{
+				for (size_t i = 0; i < dim; ++i)
+				{
+					if (++idx[i] < n) return;
+					idx[i] = 0;
+				}
+			}
+		};
+	} // ConcreteOptimizer
+
+	namespace StateParams
+	{
+		template<size_t dim>
+		struct GridSearchParams
+		{
+		public:
+			using OptAlgo = OptLib::ConcreteOptimizer::GridSearch<dim>;
+			using StateType = ConcreteState::StateGridSearch<dim>;
+
+		public:
+			Point<dim> Lower;
+			Point<dim> Upper;
+			GridSearchParams(Point<dim>&& lower, Point<dim>&& upper, size_t nodes, bool refine = true, size_t tileSize = 4096)
+				:Lower{ std::move(lower) }, Upper{ std::move(upper) }, nodes{ nodes }, refine{ refine }, tileSize{ tileSize }
+			{}
+			StateType CreateState(FuncInterface::IFunc<dim>* f)
+			{
+				return { std::move(Lower), std::move(Upper), f, nodes, refine, tileSize };
+			}
+
+		protected:
+			size_t nodes;
+			bool refine;
+			size_t tileSize;
+		};
+	} // StateParams
+} // OptLib
+
+#endif
@@ -0,0 +1,198 @@
+#ifndef LEVENBERGMARQUARDT_H
+#define LEVENBERGMARQUARDT_H
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <type_traits>
+
+#include <Eigen/Dense>
+
+#include "../../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../../Points/SetOfPoints/PointVals/Point/PointOperators.h"
+#include "../../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../../Points/SetOfPoints/PointVals/PointValOperators.h"
+
+#include "../../Functions/LeastSquares.h"
+
+#include "../../States/State.h"
+
+namespace OptLib
+{
+	namespace ConcreteState
+	{
+		/// @brief State of the Levenberg-Marquardt method: the normal equations at the guess in the scaled
+		/// variables D a, where D^2 is the largest diagonal of J^T J met so far (More, 1978), kept as
+		/// the eigendecomposition Q diag(Lambda) Q^T of D^-1 J^T J D^-1. The step for any damping mu is then
+		/// D^-1 Q (Lambda + mu)^-1 Q^T D^-1 J^T r, so a change of the damping costs O(dimP^2) without a new factorization
+		template<size_t dimX, size_t dimP>
+		class StateLevenbergMarquardt : public StatePoint<dimP>
+		{
+		protected:
+			using Base = StatePoint<dimP>;
+			using Base::dx;
+			using Base::ItsGuess;
+
+			using Matrix = Eigen::Matrix<double, dimP, dimP>;
+			using Vector = Eigen::Matrix<double, dimP, 1>;
+
+			Matrix Q;
+			Vector Lambda;
+			// Q^T D^-1 J^T r
+			Vector C;
+			Vector D{ Vector::Zero() };
+			// the step of the last Step() in the eigenbasis
+			Vector Z;
+			double Mu;
+			double Nu{ 2.0 };
+
+		public:
+			constexpr static const char* CheckpointTag = "LevenbergMarquardt";
+			using CheckpointParts = std::tuple<std::integral_constant<size_t, dimX>>;
+			using func_type = ConcreteFunc::LeastSquares<dimX, dimP>;
+			using Base::Guess;
+
+			/// @param tau The initial damping relative to the scaled J^T J, whose diagonal is 1
+			StateLevenbergMarquardt(Point<dimP>&& x0, const func_type* f, double tau) :
+				Base{ PointVal<dimP>{} },
+				Mu{ tau }
+			{
+				Hess<dimP> JtJ;
+				Grad<dimP> Jtr;
+				const double v = f->Normal(x0, JtJ, Jtr);
+				ItsGuess = PointVal<dimP>{ std::move(x0), v };
+				Factorize(JtJ, Jtr);
+			}
+
+			double Damping() const { return Mu; }
+
+			/// @brief Step of the damped normal equations (J^T J + mu D^2) p = -J^T r
+			Point<dimP> Step()
+			{
+				Z = -C.cwiseQuotient(Lambda + Vector::Constant(Mu));
+				const Vector p = (Q * Z).cwiseQuotient(D);
+				Point<dimP> out;
+				for (size_t i = 0; i < dimP; ++i)
+					out[i] = p[i];
+				return out;
+			}
+
+			/// @brief Decrease of the Gauss-Newton model along the last step
+			double Predicted() const
+			{
+				return -(C.dot(Z) + 0.5 * Z.dot(Lambda.cwiseProduct(Z)));
+			}
+
+			using Base::UpdateState;
+			/// @brief Moves to an accepted point and relaxes the damping by the gain ratio rho (Nielsen, 1999)
+			void UpdateState(const PointVal<dimP>& v, const Hess<dimP>& JtJ, const Grad<dimP>& Jtr, double rho)
+			{
+				UpdateState(v);
+				Factorize(JtJ, Jtr);
+				const double q = 2.0 * rho - 1.0;
+				Mu *= std::max(1.0 / 3.0, 1.0 - q * q * q);
+				Nu = 2.0;
+			}
+
+			/// @brief Keeps the point after a rejected step p and raises the damping. The convergence is measured by
+			/// the rejected step, which shrinks as the damping grows
+			void Reject(const Point<dimP>& p, double predicted)
+			{
+				dx = PointVal<dimP>{ abs(p), std::abs(predicted) };
+				Mu *= Nu;
+				Nu *= 2.0;
+			}
+
+			template<typename archive>
+			void Serialize(archive& ar)
+			{
+				Base::Serialize(ar);
+				ar(Q, Lambda, C, D, Z, Mu, Nu);
+			}
+
+		protected:
+			void Factorize(const Hess<dimP>& JtJ, const Grad<dimP>& Jtr)
+			{
+				for (size_t i = 0; i < dimP; ++i)
+					D[i] = std::max(D[i], std::sqrt(JtJ[i][i]));
+				for (size_t i = 0; i < dimP; ++i)
+					if (!(D[i] > 0.0)) D[i] = 1.0; // the residuals do not depend on a_i so far
+
+				Matrix S;
+				Vector g;
+				for (size_t i = 0; i < dimP; ++i)
+				{
+					for (size_t j = 0; j < dimP; ++j)
+						S(i, j) = JtJ[i][j] / (D[i] * D[j]);
+					g[i] = Jtr[i] / D[i];
+				}
+				Eigen::SelfAdjointEigenSolver<Matrix> es(S);
+				Q = es.eigenvectors();
+				Lambda = es.eigenvalues().cwiseMax(0.0); // J^T J is semidefinite up to the rounding
+				C = Q.transpose() * g;
+			}
+		};
+	} // ConcreteState
+
+	namespace ConcreteOptimizer
+	{
+		/// @brief Levenberg-Marquardt method for the least-squares fits (Madsen, Nielsen, Tingleff, 2004, sec. 3.2).
+		/// Every step is a trial of the damped Gauss-Newton step: the residuals and the Jacobian at the trial point
+		/// are computed in one pass over the samples, see LeastSquares::Normal. An accepted step refactors
+		/// the normal equations of dimP x dimP, a rejected step only raises the damping
+		template<size_t dimX, size_t dimP>
+		class LevenbergMarquardt
+		{
+		public:
+			static PointVal<dimP> Proceed(ConcreteState::StateLevenbergMarquardt<dimX, dimP>& State, const ConcreteFunc::LeastSquares<dimX, dimP>* f)
+			{
+				const PointVal<dimP> x{ State.Guess() };
+				Point<dimP> p{ State.Step() };
+				const double pred = State.Predicted();
+				if (!(pred > 0.0))
+				{ // J^T r vanishes, dx == 0 means convergence
+					State.UpdateState(x);
+					return State.Guess();
+				}
+
+				Hess<dimP> JtJ;
+				Grad<dimP> Jtr;
+				PointVal<dimP> y{ x.P + p, 0.0 };
+				y.Val = f->Normal(y.P, JtJ, Jtr);
+				const double rho = (x.Val - y.Val) / pred;
+
+				if (rho > 0.0)
+					State.UpdateState(y, JtJ, Jtr, rho);
+				else // NaN is rejected as well
+					State.Reject(p, pred);
+				return State.Guess();
+			}
+		};
+	} // ConcreteOptimizer
+
+	namespace StateParams
+	{
+		template<size_t dimX, size_t dimP>
+		struct LevenbergMarquardtParams
+		{
+		public:
+			using OptAlgo = OptLib::ConcreteOptimizer::LevenbergMarquardt<dimX, dimP>;
+			using StateType = ConcreteState::StateLevenbergMarquardt<dimX, dimP>;
+
+		public:
+			Point<dimP> StartPoint;
+			LevenbergMarquardtParams(Point<dimP>&& sop, double tau = 1.0E-3)
+				:StartPoint{ std::move(sop) }, tau{ tau }
+			{}
+			StateType CreateState(ConcreteFunc::LeastSquares<dimX, dimP>* f)
+			{
+				return { std::move(StartPoint), f, tau };
+			}
+
+		protected:
+			double tau;
+		};
+	} // StateParams
+} // OptLib
+
+#endif
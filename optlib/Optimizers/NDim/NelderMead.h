@@ -1,16 +1,18 @@
 #ifndef NELDERMEAD_H
 #define NELDERMEAD_H
 
-#include "../../Points/SetOfPoints/PointVal/Point/Point.h"
-#include "../../Points/SetOfPoints/PointVal/Point/PointOperators.h"
-#include "../../Points/SetOfPoints/PointVal/PointVal.h"
-#include "../../Points/SetOfPoints/PointVal/PointValOperators.h"
+#include "../../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../../Points/SetOfPoints/PointVals/Point/PointOperators.h"
+#include "../../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../../Points/SetOfPoints/PointVals/PointValOperators.h"
 #include "../../Points/SetOfPoints/SetOfPoints.h"
 
 #include "../../Functions/Interface/FuncInterface.h"
 
 #include "../../States/State.h"
 
+#include "../AskTell.h"
+
 namespace OptLib
 {
 	namespace ConcreteState
@@ -22,6 +24,7 @@ namespace OptLib
 		class StateNelderMead : public StateDirect<dim>
 		{
 		public:
+			constexpr static const char* CheckpointTag = "NelderMead";
 			const double alpha;
 			const double beta;
 			const double gamma;
@@ -31,7 +34,37 @@ namespace OptLib
 				double alpha_, double beta_, double gamma_) : StateDirect<dim>(std::move(State), f),
 				alpha{ alpha_ }, beta{ beta_ }, gamma{ gamma_ }{};
 		};
-	} // ConcreteOptimizer
+
+		/// @brief Nelder-Mead state that replaces a single vertex by binary insertion and takes the centroid 
+		/// from the running mean of the domain, so the bookkeeping of an iteration is O(dim) instead of O(dim^2 + dim log dim).
+		/// The sums are recalculated from scratch after squeezing and every RecenterPeriod replacements to remove round-off drift
+		template<size_t dim>
+		class StateNelderMeadIncremental : public StateNelderMead<dim>
+		{
+			using Base = StateNelderMead<dim>;
+
+		public:
+			constexpr static const char* CheckpointTag = "NelderMeadIncremental";
+			StateNelderMeadIncremental(Simplex<dim>&& State, FuncInterface::IFunc<dim>* f,
+				double alpha_, double beta_, double gamma_, size_t recenterPeriod = 8 * (dim + 1)) : 
+				Base(std::move(State), f, alpha_, beta_, gamma_)
+			{
+				this->RecenterPeriod = recenterPeriod;
+			}
+
+			/// @brief Center of the simplex excluding the point with the largest Val
+			Point<dim> Centroid() const
+			{
+				return (this->ItsDispersion.mean().P * (dim + 1.0) - this->GuessDomain()[dim].P) / (dim - 0.0);
+			}
+
+			/// @brief Substitutes the point with the largest Val
+			void ReplaceWorst(PointVal<dim>&& v)
+			{
+				this->ReplaceVertex(dim, std::move(v));
+			}
+		};
+	} // ConcreteState
 
 	namespace ConcreteOptimizer
 	{
@@ -42,73 +75,283 @@ namespace OptLib
 
 			static PointVal<dim> Proceed(ConcreteState::StateNelderMead<dim>& State, const FuncInterface::IFunc<dim>* f)
 			{
-				double alpha = State.alpha;
-				double beta = State.beta;
-				double gamma = State.gamma;
-
-				SetOfPoints<dim + 1, PointVal<dim>> NewSimplex = State.GuessDomain().Points();
-
-				// auxillary points
-				// they MUST be aliases for the concrete points in NewSimplex
-				PointVal<dim>& xl = NewSimplex[0];
-				PointVal<dim>& xh = NewSimplex[dim];
-				PointVal<dim>& xg = NewSimplex[dim - 1];
+				SimplexVal<dim> NewSimplex{ Vertices(State) };
 
 				// simplex center excluding the point with the largest Val
-				Point<dim> XC = NewSimplex[0].P;
-				for (int i = 1; i < dim; i++)
-					XC = XC + NewSimplex[i].P;
-				PointVal<dim> xc{ FuncInterface::CreateFromPoint<dim>(std::move(XC / (dim - 0.0)), f) };
+				Point<dim> xc{ Centroid(NewSimplex) };
 
 				// another auxillary point
-				PointVal<dim> xr{ FuncInterface::CreateFromPoint<dim>(std::move(xc.P * (1.0 + alpha) - xh.P * alpha), f) };
+				PointVal<dim> xr{ FuncInterface::CreateFromPoint<dim>(Reflect(xc, NewSimplex[dim].P, State.alpha), f) };
+
+				bool updated = UpdateWorst(NewSimplex, xr,
+					[&]()
+					{ // try to slightly improve the xr value calculating xe
+						return FuncInterface::CreateFromPoint<dim>(Expand(xc, xr.P, State.gamma), f);
+					},
+					[&](bool)
+					{ // the worst point is already replaced with xr if xr is better
+						return FuncInterface::CreateFromPoint<dim>(Contract(xc, NewSimplex[dim].P, State.beta), f);
+					});
+
+				if (updated)
+					State.SetDomain(std::move(NewSimplex));
+				else
+				{
+					SetOfPoints<dim, Point<dim>> Squeezed{ SqueezeSimplex(NewSimplex) };
+					SetOfPoints<dim, PointVal<dim>> SqueezedVals;
+					for (size_t i = 0; i < dim; ++i)
+						SqueezedVals[i] = FuncInterface::CreateFromPoint<dim>(std::move(Squeezed[i]), f);
+					State.SetDomain(AssembleSimplex(NewSimplex[0], std::move(SqueezedVals)));
+				}
+				return State.Guess();
+			}
+
+		protected:
+			static SimplexVal<dim> Vertices(const ConcreteState::StateNelderMead<dim>& State)
+			{
+				return SimplexVal<dim>{ static_cast<const SimplexVal<dim>&>(State.GuessDomain()) };
+			}
+
+			/// @brief Center of the sorted simplex excluding the point with the largest Val
+			static Point<dim> Centroid(const SimplexVal<dim>& Simplex)
+			{
+				Point<dim> XC = Simplex[0].P;
+				for (size_t i = 1; i < dim; i++)
+					XC = XC + Simplex[i].P;
+				return XC / (dim - 0.0);
+			}
 
+			static Point<dim> Reflect(const Point<dim>& xc, const Point<dim>& xh, double alpha)
+			{
+				return xc * (1.0 + alpha) - xh * alpha;
+			}
+			static Point<dim> Expand(const Point<dim>& xc, const Point<dim>& xr, double gamma)
+			{
+				return xc * (1.0 - gamma) + xr * gamma;
+			}
+			static Point<dim> Contract(const Point<dim>& xc, const Point<dim>& x, double beta)
+			{
+				return x * beta + xc * (1.0 - beta);
+			}
+
+			/// @brief Nelder-Mead rules for replacement of the worst point of the sorted simplex
+			/// @param trialE Returns the expansion point
+			/// @param trialS Returns the contraction point. The argument is true for the contraction outside, i.e., towards xr
+			/// @return false if none of the trial points is accepted and the simplex must be squeezed
+			template<typename expansion, typename contraction>
+			static bool UpdateWorst(SimplexVal<dim>& Simplex, const PointVal<dim>& xr, expansion&& trialE, contraction&& trialS)
+			{
+				// auxillary points
+				// they MUST be aliases for the concrete points in Simplex
+				return UpdateVertex(Simplex[0], Simplex[dim - 1], Simplex[dim], xr,
+					std::forward<expansion>(trialE), std::forward<contraction>(trialS));
+			}
+
+			/// @brief The same rules for an arbitrary vertex xh
+			/// @param xl The best point of the simplex
+			/// @param xg The point that xr must beat to be accepted without expansion or contraction
+			template<typename expansion, typename contraction>
+			static bool UpdateVertex(const PointVal<dim>& xl, const PointVal<dim>& xg, PointVal<dim>& xh, 
+				const PointVal<dim>& xr, expansion&& trialE, contraction&& trialS)
+			{
 				if (xr.Val < xl.Val)
 				{
-					// try to slightly improve the xr value calculating xe
-					PointVal<dim> xe{ FuncInterface::CreateFromPoint<dim>(std::move(xc * (1.0 - gamma) + xr * gamma), f) };
+					PointVal<dim> xe{ trialE() };
 					if (xe.Val < xr.Val)
 						xh = xe;
 					else
 						xh = xr;
-					State.SetDomain(std::move(NewSimplex));
-					return State.Guess();
+					return true;
 				}
 
 				if (xr.Val < xg.Val)
 				{
 					xh = xr;
-					State.SetDomain(std::move(NewSimplex));
-					return State.Guess();
+					return true;
 				}
 
-				if (xr.Val < xh.Val) xh = xr; // std::swap(xr, xh);
+				bool outside = xr.Val < xh.Val;
+				if (outside) xh = xr; // std::swap(xr, xh);
 
-				PointVal<dim> xs{ FuncInterface::CreateFromPoint<dim>(std::move(xh.P * beta + xc.P * (1 - beta)), f) };
+				PointVal<dim> xs{ trialS(outside) };
 				if (xs.Val < xh.Val)
 				{
 					xh = xs;
-					State.SetDomain(std::move(NewSimplex));
-					return State.Guess();
+					return true;
 				}
+				return false;
+			}
 
-				State.UpdateDomain(SqueezeSimplex(xl.P, NewSimplex), f);
-				return State.Guess();
-				}
-			    
-		protected:
-			static auto SqueezeSimplex(const Point<dim>& xl, const SetOfPoints<dim + 1, PointVal<dim>>& Simplex)
+			/// @brief Points of the simplex squeezed twice towards the best point, the best point itself is excluded
+			static auto SqueezeSimplex(const SimplexVal<dim>& Simplex)
 			{
-				Simplex<dim> NewSimplex;
+				const Point<dim>& xl = Simplex[0].P;
+				SetOfPoints<dim, Point<dim>> NewSimplex;
 
-				for (int i = 0; i < dim + 1; i++)
-					NewSimplex[i] = Point<dim>{ std::move(xl + (Simplex[i].P - xl) / 2.0) };
+				for (size_t i = 0; i < dim; i++)
+					NewSimplex[i] = Point<dim>{ xl + (Simplex[i + 1].P - xl) / 2.0 };
 
 				return NewSimplex;
 			}
+
+			static SimplexVal<dim> AssembleSimplex(const PointVal<dim>& xl, SetOfPoints<dim, PointVal<dim>>&& Squeezed)
+			{
+				SimplexVal<dim> NewSimplex;
+				NewSimplex[0] = xl;
+				for (size_t i = 0; i < dim; i++)
+					NewSimplex[i + 1] = std::move(Squeezed[i]);
+				return NewSimplex;
+			}
+		};
+
+		/// @brief Nelder-Mead on StateNelderMeadIncremental. The simplex is not copied unless it is squeezed
+		template<size_t dim>
+		class NelderMeadIncremental : public NelderMead<dim>
+		{
+			using Base = NelderMead<dim>;
+
+		public:
+			static PointVal<dim> Proceed(ConcreteState::StateNelderMeadIncremental<dim>& State, const FuncInterface::IFunc<dim>* f)
+			{
+				const auto& S = State.GuessDomain();
+
+				Point<dim> xc{ State.Centroid() };
+				PointVal<dim> xh{ S[dim] };
+				PointVal<dim> xr{ FuncInterface::CreateFromPoint<dim>(Base::Reflect(xc, xh.P, State.alpha), f) };
+
+				bool updated = Base::UpdateVertex(S[0], S[dim - 1], xh, xr,
+					[&]()
+					{
+						return FuncInterface::CreateFromPoint<dim>(Base::Expand(xc, xr.P, State.gamma), f);
+					},
+					[&](bool)
+					{
+						return FuncInterface::CreateFromPoint<dim>(Base::Contract(xc, xh.P, State.beta), f);
+					});
+
+				if (updated)
+					State.ReplaceWorst(std::move(xh));
+				else
+				{
+					SimplexVal<dim> NewSimplex{ Base::Vertices(State) };
+					SetOfPoints<dim, Point<dim>> Squeezed{ Base::SqueezeSimplex(NewSimplex) };
+					SetOfPoints<dim, PointVal<dim>> SqueezedVals;
+					for (size_t i = 0; i < dim; ++i)
+						SqueezedVals[i] = FuncInterface::CreateFromPoint<dim>(std::move(Squeezed[i]), f);
+					State.SetDomain(Base::AssembleSimplex(NewSimplex[0], std::move(SqueezedVals)));
+				}
+				return State.Guess();
+			}
 		};
 	}//ConcreteOptimizer
 
+	namespace StateParams
+	{
+		template<size_t dim>
+		struct NelderMeadParams;
+	} // StateParams
+
+	namespace ConcreteOptimizer
+	{
+		/// @brief Nelder-Mead as an ask/tell state machine, see OptimizerInterface::AskTell. A step asks for the reflection,
+		/// then for the expansion or the contraction if the reflection is not accepted by itself, and for the dim squeezed
+		/// points if the simplex is squeezed. The points and the decisions are the same as those of NelderMead::Proceed
+		template<size_t dim>
+		class NelderMeadAskTell :
+			public OptimizerInterface::AskTell<NelderMeadAskTell<dim>, StateParams::NelderMeadParams<dim>>,
+			protected NelderMead<dim>
+		{
+			using Base = OptimizerInterface::AskTell<NelderMeadAskTell<dim>, StateParams::NelderMeadParams<dim>>;
+			using Algo = NelderMead<dim>;
+			friend Base;
+
+		public:
+			using Base::Base;
+
+		protected:
+			enum class Phase { Reflect, Expand, Contract, Squeeze };
+			Phase Next{ Phase::Reflect };
+			SimplexVal<dim> NewSimplex;
+			Point<dim> xc;
+			PointVal<dim> xr;
+
+			void Propose(std::vector<Point<dim>>& out)
+			{
+				const auto& State = *this->ItsState;
+				switch (Next)
+				{
+				case Phase::Reflect:
+					NewSimplex = Algo::Vertices(State);
+					xc = Algo::Centroid(NewSimplex);
+					out.push_back(Algo::Reflect(xc, NewSimplex[dim].P, State.alpha));
+					break;
+				case Phase::Expand:
+					out.push_back(Algo::Expand(xc, xr.P, State.gamma));
+					break;
+				case Phase::Contract:
+					out.push_back(Algo::Contract(xc, NewSimplex[dim].P, State.beta));
+					break;
+				case Phase::Squeeze:
+					for (auto& x : Algo::SqueezeSimplex(NewSimplex))
+						out.push_back(std::move(x));
+					break;
+				}
+			}
+
+			void Complete(const double* v)
+			{
+				const auto& x = this->Asked;
+				PointVal<dim>& xh = NewSimplex[dim];
+				switch (Next)
+				{
+				case Phase::Reflect:
+					xr = PointVal<dim>{ x[0], v[0] };
+					if (xr.Val < NewSimplex[0].Val)
+						Next = Phase::Expand;
+					else if (xr.Val < NewSimplex[dim - 1].Val)
+					{
+						xh = xr;
+						Accept();
+					}
+					else
+					{
+						if (xr.Val < xh.Val) xh = xr; // the contraction outside
+						Next = Phase::Contract;
+					}
+					break;
+				case Phase::Expand:
+					xh = v[0] < xr.Val ? PointVal<dim>{ x[0], v[0] } : xr;
+					Accept();
+					break;
+				case Phase::Contract:
+					if (v[0] < xh.Val)
+					{
+						xh = PointVal<dim>{ x[0], v[0] };
+						Accept();
+					}
+					else
+						Next = Phase::Squeeze;
+					break;
+				case Phase::Squeeze:
+				{
+					SetOfPoints<dim, PointVal<dim>> SqueezedVals;
+					for (size_t i = 0; i < dim; ++i)
+						SqueezedVals[i] = PointVal<dim>{ x[i], v[i] };
+					this->ItsState->SetDomain(Algo::AssembleSimplex(NewSimplex[0], std::move(SqueezedVals)));
+					Next = Phase::Reflect;
+					break;
+				}
+				}
+			}
+
+			void Accept()
+			{
+				this->ItsState->SetDomain(std::move(NewSimplex));
+				Next = Phase::Reflect;
+			}
+		};
+	} // ConcreteOptimizer
+
 	namespace StateParams
 	{
 		template< size_t dim>
@@ -124,7 +367,7 @@ namespace OptLib
 				:StartSimplex{ std::move(sop) },
 				alpha{ alpha_ }, beta{ beta_ }, gamma{ gamma_ }
 			{}
-			StateType CreateState(FuncInterface::IFunc<1>* f)
+			StateType CreateState(FuncInterface::IFunc<dim>* f)
 			{
 				return { std::move(StartSimplex), f, alpha, beta, gamma };
 			}
@@ -134,6 +377,21 @@ namespace OptLib
 			double beta;
 			double gamma;
 		};
+
+		template< size_t dim>
+		struct NelderMeadIncrementalParams : public NelderMeadParams<dim>
+		{
+		public:
+			using OptAlgo = OptLib::ConcreteOptimizer::NelderMeadIncremental<dim>;
+			using StateType = ConcreteState::StateNelderMeadIncremental<dim>;
+
+		public:
+			using NelderMeadParams<dim>::NelderMeadParams;
+			StateType CreateState(FuncInterface::IFunc<dim>* f)
+			{
+				return { std::move(this->StartSimplex), f, this->alpha, this->beta, this->gamma };
+			}
+		};
 	} // StateParams
 }//OptLib
 
@@ -0,0 +1,262 @@
+#ifndef NELDERMEADPARALLEL_H
+#define NELDERMEADPARALLEL_H
+
+#include <algorithm>
+#include <cmath>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <Eigen/Dense>
+
+#include "NelderMead.h"
+
+namespace OptLib
+{
+	namespace ConcreteState
+	{
+		/// @brief Nelder-Mead state for the method that updates several worst vertices at once
+		template<size_t dim>
+		class StateNelderMeadMultiVertex : public StateNelderMead<dim>
+		{
+		public:
+			constexpr static const char* CheckpointTag = "NelderMeadMultiVertex";
+			// number of the worst vertices updated concurrently, 1 <= Workers <= max(dim / 2, 1).
+			// Larger values leave too few points for the centroid and the simplex degenerates
+			const size_t Workers;
+			// the simplex is rebuilt if the inverse condition number of its edges falls below it, see IsDegenerate
+			const double Degeneracy;
+
+			// iterations since the last test of the degeneracy
+			size_t SinceCheck{ 0 };
+			size_t Rebuilds{ 0 };
+
+		public:
+			StateNelderMeadMultiVertex(Simplex<dim>&& State, FuncInterface::IFunc<dim>* f,
+				double alpha_, double beta_, double gamma_, size_t workers, double degeneracy = 1E-4) : 
+				StateNelderMead<dim>(std::move(State), f, alpha_, beta_, gamma_),
+				Workers{ std::clamp<size_t>(workers, 1, std::max<size_t>(dim / 2, 1)) },
+				Degeneracy{ degeneracy }{};
+
+			/// @brief A degenerate simplex is not converged: it has lost some directions and only shrinks along the rest
+			bool IsConverged(double abs_tol, double rel_tol) const override
+			{
+				return StateNelderMead<dim>::IsConverged(abs_tol, rel_tol) && (Workers == 1 || !IsDegenerate());
+			}
+
+			/// @brief Whether the edges from the best vertex are close to linearly dependent. The ratio of the smallest
+			/// and the largest diagonal elements of the pivoted QR estimates the inverse condition number of the edges. O(dim^3)
+			bool IsDegenerate() const
+			{
+				const auto& S = this->GuessDomain();
+				Eigen::MatrixXd E(dim, dim);
+				for (size_t j = 0; j < dim; ++j)
+					for (size_t i = 0; i < dim; ++i)
+						E(static_cast<long>(i), static_cast<long>(j)) = S[j + 1].P[i] - S[0].P[i];
+				Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr(E);
+				const auto d = qr.matrixQR().diagonal().cwiseAbs();
+				return !(d.minCoeff() >= Degeneracy * d.maxCoeff());
+			}
+
+			template<typename archive>
+			void Serialize(archive& ar)
+			{
+				StateNelderMead<dim>::Serialize(ar);
+				ar(SinceCheck, Rebuilds);
+			}
+		};
+	} // ConcreteState
+
+	namespace ConcreteOptimizer
+	{
+		/// @brief Nelder-Mead that evaluates the reflection, the expansion and both contractions concurrently.
+		/// The accepted point is chosen by the rules of the serial NelderMead, so the trajectories coincide.
+		/// The points of the squeezed simplex are evaluated concurrently as well.
+		/// An iteration costs about one evaluation of wall-time, but up to 3 evaluations are wasted,
+		/// so the method pays off for expensive objectives only. f must be thread-safe
+		template<size_t dim>
+		class NelderMeadSpeculative : public NelderMead<dim>
+		{
+			using Base = NelderMead<dim>;
+
+		public:
+			static PointVal<dim> Proceed(ConcreteState::StateNelderMead<dim>& State, const FuncInterface::IFunc<dim>* f)
+			{
+				SimplexVal<dim> NewSimplex{ Base::Vertices(State) };
+
+				Point<dim> xc{ Base::Centroid(NewSimplex) };
+				Point<dim> xr{ Base::Reflect(xc, NewSimplex[dim].P, State.alpha) };
+
+				// every trial point depends on xc, xr, and xh only
+				auto Trial{ FuncInterface::CreateFromPoints<4, dim>(
+					SetOfPoints<4, Point<dim>>{
+						xr,
+						Base::Expand(xc, xr, State.gamma),
+						Base::Contract(xc, xr, State.beta),
+						Base::Contract(xc, NewSimplex[dim].P, State.beta) },
+					f) };
+
+				bool updated = Base::UpdateWorst(NewSimplex, Trial[0],
+					[&]() { return Trial[1]; },
+					[&](bool outside) { return outside ? Trial[2] : Trial[3]; });
+
+				if (updated)
+					State.SetDomain(std::move(NewSimplex));
+				else
+					State.SetDomain(Base::AssembleSimplex(NewSimplex[0],
+						FuncInterface::CreateFromPoints<dim, dim>(Base::SqueezeSimplex(NewSimplex), f)));
+				return State.Guess();
+			}
+		};
+
+		/// @brief Parallel Nelder-Mead of Lee and Wiswall. Each of p workers applies the Nelder-Mead rules
+		/// to its own vertex among the p worst ones, using the centroid of the dim + 1 - p best vertices.
+		/// The updates are committed together. The simplex is squeezed only if none of the workers succeeded.
+		/// With p > 1 the simplex tends to collapse into a subspace and to shrink there away from the minimum, so it is tested
+		/// every dim iterations and rebuilt if it has degenerated, see StateNelderMeadMultiVertex::IsDegenerate.
+		/// For p == 1 the method coincides with NelderMead. f must be thread-safe
+		template<size_t dim>
+		class NelderMeadMultiVertex : public NelderMead<dim>
+		{
+			using Base = NelderMead<dim>;
+
+		public:
+			static PointVal<dim> Proceed(ConcreteState::StateNelderMeadMultiVertex<dim>& State, const FuncInterface::IFunc<dim>* f)
+			{
+				SimplexVal<dim> NewSimplex{ Base::Vertices(State) };
+
+				const size_t p = State.Workers;
+				const size_t kept = dim + 1 - p;
+				const Point<dim> xc{ Centroid(NewSimplex, kept) };
+
+				SetOfPoints<dim, PointVal<dim>> Updated;
+				std::array<bool, dim> improved{};
+
+#pragma omp parallel for schedule(dynamic, 1)
+				for (long long j = 0; j < static_cast<long long>(p); ++j)
+				{
+					PointVal<dim> xh{ NewSimplex[kept + j] };
+					PointVal<dim> xr{ FuncInterface::CreateFromPoint<dim>(Base::Reflect(xc, xh.P, State.alpha), f) };
+
+					improved[j] = Base::UpdateVertex(NewSimplex[0], NewSimplex[kept - 1], xh, xr,
+						[&]()
+						{
+							return FuncInterface::CreateFromPoint<dim>(Base::Expand(xc, xr.P, State.gamma), f);
+						},
+						[&](bool)
+						{
+							return FuncInterface::CreateFromPoint<dim>(Base::Contract(xc, xh.P, State.beta), f);
+						});
+					Updated[j] = std::move(xh);
+				}
+
+				if (std::any_of(improved.cbegin(), improved.cbegin() + p, [](bool b) { return b; }))
+				{
+					for (size_t j = 0; j < p; ++j)
+						NewSimplex[kept + j] = std::move(Updated[j]);
+					State.SetDomain(std::move(NewSimplex));
+				}
+				else
+					State.SetDomain(Base::AssembleSimplex(NewSimplex[0],
+						FuncInterface::CreateFromPoints<dim, dim>(Base::SqueezeSimplex(NewSimplex), f)));
+
+				if (p > 1 && ++State.SinceCheck >= dim)
+				{
+					State.SinceCheck = 0;
+					if (State.IsDegenerate())
+						Rebuild(State, f);
+				}
+				return State.Guess();
+			}
+
+		protected:
+			/// @brief Replaces a collapsed simplex by the right-angled one at the best vertex. The edge along every axis is
+			/// the extent of the old simplex along it, so the scales found so far are kept, but the lost directions are restored
+			static void Rebuild(ConcreteState::StateNelderMeadMultiVertex<dim>& State, const FuncInterface::IFunc<dim>* f)
+			{
+				const auto& S = State.GuessDomain();
+				const Point<dim>& xl = S[0].P;
+
+				double diameter = 0.0;
+				Point<dim> h{};
+				for (size_t j = 1; j <= dim; ++j)
+				{
+					double d = 0.0;
+					for (size_t i = 0; i < dim; ++i)
+					{
+						const double e = std::abs(S[j].P[i] - xl[i]);
+						h[i] = std::max(h[i], e);
+						d += e * e;
+					}
+					diameter = std::max(diameter, std::sqrt(d));
+				}
+
+				SetOfPoints<dim, Point<dim>> Axes;
+				for (size_t i = 0; i < dim; ++i)
+				{
+					Axes[i] = xl;
+					Axes[i][i] += h[i] > 0.0 ? h[i] : diameter;
+				}
+				State.SetDomain(Base::AssembleSimplex(S[0], FuncInterface::CreateFromPoints<dim, dim>(std::move(Axes), f)));
+				++State.Rebuilds;
+			}
+
+			/// @brief Center of the kept best points of the sorted simplex
+			static Point<dim> Centroid(const SimplexVal<dim>& Simplex, size_t kept)
+			{
+				Point<dim> XC = Simplex[0].P;
+				for (size_t i = 1; i < kept; i++)
+					XC = XC + Simplex[i].P;
+				return XC / static_cast<double>(kept);
+			}
+		};
+	} // ConcreteOptimizer
+
+	namespace StateParams
+	{
+		template<size_t dim>
+		struct NelderMeadSpeculativeParams : public NelderMeadParams<dim>
+		{
+		public:
+			using OptAlgo = OptLib::ConcreteOptimizer::NelderMeadSpeculative<dim>;
+			using NelderMeadParams<dim>::NelderMeadParams;
+		};
+
+		template<size_t dim>
+		struct NelderMeadMultiVertexParams : public NelderMeadParams<dim>
+		{
+		public:
+			using OptAlgo = OptLib::ConcreteOptimizer::NelderMeadMultiVertex<dim>;
+			using StateType = ConcreteState::StateNelderMeadMultiVertex<dim>;
+
+		public:
+			/// @param workers Number of the worst vertices updated concurrently. 0 means the number of OpenMP threads
+			/// @param degeneracy Inverse condition number of the edges below which the simplex is rebuilt
+			NelderMeadMultiVertexParams(SetOfPoints<dim + 1, Point<dim>>&& sop, double alpha_, double beta_, double gamma_, size_t workers = 0,
+				double degeneracy = 1E-4)
+				: NelderMeadParams<dim>{ std::move(sop), alpha_, beta_, gamma_ },
+				workers{ workers > 0 ? workers : DefaultWorkers() },
+				degeneracy{ degeneracy }
+			{}
+			StateType CreateState(FuncInterface::IFunc<dim>* f)
+			{
+				return { std::move(this->StartSimplex), f, this->alpha, this->beta, this->gamma, workers, degeneracy };
+			}
+
+		protected:
+			size_t workers;
+			double degeneracy;
+
+			static size_t DefaultWorkers()
+			{
+#ifdef _OPENMP
+				return static_cast<size_t>(omp_get_max_threads());
+#else
+				return 1;
+#endif
+			}
+		};
+	} // StateParams
+} // OptLib
+
+#endif
@@ -9,6 +9,7 @@ namespace OptLib
 		class StateNewton :public ConcreteState::StatePoint<dim>
 		{
 		public:
+			constexpr static const char* CheckpointTag = "Newton";
 			StateNewton(Point<dim>&& x0, const FuncInterface::IFuncWithHess<dim>* f)
 			{
 				ItsGuess = FuncInterface::CreateFromPoint<dim>(std::move(x0), f);
@@ -0,0 +1,212 @@
+#ifndef PARALLELTEMPERING_H
+#define PARALLELTEMPERING_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "../../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../../Points/SetOfPoints/PointVals/Point/PointOperators.h"
+#include "../../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../../Points/SetOfPoints/PointVals/PointValOperators.h"
+
+#include "../../Functions/Interface/FuncInterface.h"
+
+#include "../../States/StateInterface.h"
+
+#include "../../Random/Distributions.h"
+
+namespace OptLib
+{
+	namespace ConcreteState
+	{
+		/// @brief Replica of the parallel tempering: a Metropolis chain at a fixed temperature with its own random stream
+		template<size_t dim>
+		struct TemperingChain
+		{
+			PointVal<dim> Current;
+			double Temperature;
+			double Step; // half-width of the uniform proposal
+			Random::Philox4x32 Rng;
+			size_t Accepted{ 0 };
+			size_t Proposed{ 0 };
+
+			template<typename archive>
+			void Serialize(archive& ar) { ar(Current, Temperature, Step, Rng, Accepted, Proposed); }
+		};
+
+		/// @brief State of the replica exchange annealing: K chains on a geometric temperature ladder
+		/// from TMin to TMax. The guess is the best point visited by any chain
+		template<size_t dim>
+		class StateParallelTempering : public StateInterface::IState<dim>
+		{
+		protected:
+			using Base = StateInterface::IState<dim>;
+			using Base::ItsGuess;
+
+			std::vector<TemperingChain<dim>> ItsChains;
+			Random::Philox4x32 SwapRng;
+			size_t Sweeps{ 0 };
+			double WindowStart; // the best value at the beginning of the current window of Patience sweeps
+			double WindowGain{ std::numeric_limits<double>::infinity() }; // the improvement over the last complete window
+
+		public:
+			constexpr static const char* CheckpointTag = "ParallelTempering";
+			using func_type = FuncInterface::IFunc<dim>;
+			using Base::Guess;
+
+			// Metropolis steps of every chain between two exchange phases
+			const size_t SweepLength;
+			// the state is converged if the best value improves by less than the tolerance over Patience sweeps
+			const size_t Patience;
+			size_t SwapsAccepted{ 0 };
+			size_t SwapsProposed{ 0 };
+
+			/// @param chains Number of replicas K >= 1
+			/// @param step Proposal half-width of the coldest chain. It grows as sqrt(T) along the ladder
+			/// @param seed Key of the random streams. Chain k uses stream k, the exchanges use stream K
+			StateParallelTempering(Point<dim>&& x0, const func_type* f, size_t chains, double tMin, double tMax,
+				double step, size_t sweepLength, size_t patience, std::uint64_t seed) :
+				Base{ FuncInterface::CreateFromPoint<dim>(std::move(x0), f) },
+				SwapRng{ seed, std::max<size_t>(chains, 1) },
+				WindowStart{ Guess().Val },
+				SweepLength{ std::max<size_t>(sweepLength, 1) },
+				Patience{ std::max<size_t>(patience, 1) }
+			{
+				const size_t K = std::max<size_t>(chains, 1);
+				const double ratio = K > 1 ? std::pow(tMax / tMin, 1.0 / static_cast<double>(K - 1)) : 1.0;
+				ItsChains.reserve(K);
+				double T = tMin;
+				for (size_t k = 0; k < K; ++k, T *= ratio)
+					ItsChains.push_back(TemperingChain<dim>{ Guess(), T, step * std::sqrt(T / tMin), Random::Philox4x32{ seed, k } });
+			}
+
+			std::vector<TemperingChain<dim>>& Chains() { return ItsChains; }
+			const std::vector<TemperingChain<dim>>& Chains() const { return ItsChains; }
+			Random::Philox4x32& ExchangeRng() { return SwapRng; }
+			size_t SweepCount() const { return Sweeps; }
+
+			bool IsConverged(double abs_tol, double rel_tol) const override
+			{
+				return WindowGain < abs_tol || WindowGain < rel_tol * std::abs(Guess().Val);
+			}
+
+			/// @brief Takes the best point of the chains after a sweep
+			void UpdateState()
+			{
+				for (const auto& c : ItsChains)
+					if (c.Current < ItsGuess)
+						ItsGuess = c.Current;
+
+				if (++Sweeps % Patience == 0)
+				{
+					WindowGain = WindowStart - ItsGuess.Val;
+					WindowStart = ItsGuess.Val;
+				}
+			}
+
+			template<typename archive>
+			void Serialize(archive& ar)
+			{
+				Base::Serialize(ar);
+				ar(ItsChains, SwapRng, Sweeps, WindowStart, WindowGain, SwapsAccepted, SwapsProposed);
+			}
+		};
+	} // ConcreteState
+
+	namespace ConcreteOptimizer
+	{
+		/// @brief Parallel tempering (replica exchange Monte Carlo).
+		/// Every iteration the chains make SweepLength Metropolis steps concurrently on the OpenMP threads,
+		/// then the neighbouring temperatures exchange their points with probability
+		/// min{1, exp((1/T_i - 1/T_j)(f_i - f_j))}. Even and odd pairs alternate between iterations.
+		/// Every chain draws from its own stream, so the result does not depend on the number of threads.
+		/// f must be thread-safe
+		template<size_t dim>
+		class ParallelTempering
+		{
+		public:
+			static PointVal<dim> Proceed(ConcreteState::StateParallelTempering<dim>& State, const FuncInterface::IFunc<dim>* f)
+			{
+				auto& chains = State.Chains();
+				const size_t K = chains.size();
+				const size_t steps = State.SweepLength;
+
+#pragma omp parallel for schedule(dynamic, 1)
+				for (long long k = 0; k < static_cast<long long>(K); ++k)
+					Sweep(chains[k], f, steps);
+
+				auto& rng = State.ExchangeRng();
+				for (size_t i = State.SweepCount() % 2; i + 1 < K; i += 2)
+				{
+					auto& cold = chains[i];
+					auto& hot = chains[i + 1];
+					double a = (1.0 / cold.Temperature - 1.0 / hot.Temperature) * (cold.Current.Val - hot.Current.Val);
+					++State.SwapsProposed;
+					if (a >= 0.0 || rng.Uniform() < std::exp(a))
+					{
+						std::swap(cold.Current, hot.Current);
+						++State.SwapsAccepted;
+					}
+				}
+
+				State.UpdateState();
+				return State.Guess();
+			}
+
+		protected:
+			static void Sweep(ConcreteState::TemperingChain<dim>& c, const FuncInterface::IFunc<dim>* f, size_t steps)
+			{
+				for (size_t s = 0; s < steps; ++s)
+				{
+					PointVal<dim> y{ FuncInterface::CreateFromPoint<dim>(Random::UniformPoint(c.Rng, c.Current.P, c.Step), f) };
+
+					++c.Proposed;
+					double d = c.Current.Val - y.Val;
+					if (d >= 0.0 || c.Rng.Uniform() < std::exp(d / c.Temperature))
+					{
+						c.Current = std::move(y);
+						++c.Accepted;
+					}
+				}
+			}
+		};
+	} // ConcreteOptimizer
+
+	namespace StateParams
+	{
+		template<size_t dim>
+		struct ParallelTemperingParams
+		{
+		public:
+			using OptAlgo = OptLib::ConcreteOptimizer::ParallelTempering<dim>;
+			using StateType = ConcreteState::StateParallelTempering<dim>;
+
+		public:
+			Point<dim> StartPoint;
+			ParallelTemperingParams(Point<dim>&& sop, size_t chains, double tMin, double tMax, double step,
+				size_t sweepLength = 100, size_t patience = 20, std::uint64_t seed = 0)
+				:StartPoint{ std::move(sop) }, chains{ chains }, tMin{ tMin }, tMax{ tMax }, step{ step },
+				sweepLength{ sweepLength }, patience{ patience }, seed{ seed }
+			{}
+			StateType CreateState(FuncInterface::IFunc<dim>* f)
+			{
+				return { std::move(StartPoint), f, chains, tMin, tMax, step, sweepLength, patience, seed };
+			}
+
+		protected:
+			size_t chains;
+			double tMin;
+			double tMax;
+			double step;
+			size_t sweepLength;
+			size_t patience;
+			std::uint64_t seed;
+		};
+	} // StateParams
+} // OptLib
+
+#endif
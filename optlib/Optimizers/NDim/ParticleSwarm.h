@@ -0,0 +1,208 @@
+#ifndef PARTICLESWARM_H
+#define PARTICLESWARM_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "../../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../../Points/SetOfPoints/Population.h"
+
+#include "../../Functions/Interface/FuncInterface.h"
+
+#include "../../States/StatePopulation.h"
+
+#include "../../Random/Distributions.h"
+
+#include "../AskTell.h"
+
+namespace OptLib
+{
+	namespace ConcreteState
+	{
+		/// @brief State of the particle swarm: positions X, velocities and personal bests.
+		/// The guess is the global best
+		template<size_t dim>
+		class StateParticleSwarm : public StateInterface::StatePopulation<dim>
+		{
+		protected:
+			using Base = StateInterface::StatePopulation<dim>;
+
+		public:
+			constexpr static const char* CheckpointTag = "ParticleSwarm";
+			using func_type = typename Base::func_type;
+
+			// inertia weight
+			const double W;
+			// cognitive and social accelerations
+			const double C1, C2;
+
+			Population<dim> Velocity;
+			Population<dim> Best;
+			std::vector<double> FBest;
+			// the largest speed along every axis, a fraction of the box
+			Point<dim> VMax;
+			// uniform variates of a step: r1 of all the coordinates, then r2
+			std::vector<double> R;
+
+			StateParticleSwarm(Point<dim>&& lower, Point<dim>&& upper, const func_type* f, size_t size,
+				double w, double c1, double c2, double vmax, std::uint64_t seed) :
+				Base{ std::move(lower), std::move(upper), f, size, seed },
+				W{ w }, C1{ c1 }, C2{ c2 },
+				Velocity(this->Size()), Best{ this->X }, FBest{ this->FX },
+				R(2 * dim * this->Size())
+			{
+				for (size_t i = 0; i < dim; ++i)
+				{
+					const double range = this->Upper()[i] - this->Lower()[i];
+					VMax[i] = vmax * range;
+					Random::FillUniform(this->Rng, Velocity.Axis(i), this->Size(), -VMax[i], VMax[i]);
+				}
+			}
+
+			template<typename archive>
+			void Serialize(archive& ar)
+			{
+				Base::Serialize(ar);
+				ar(Velocity, Best, FBest, VMax);
+			}
+		};
+	} // ConcreteState
+
+	namespace ConcreteOptimizer
+	{
+		/// @brief Particle swarm optimization with the inertia weight (Shi, Eberhart, 1998) and the global topology.
+		/// The velocity and position updates run along one axis of the column-major swarm at a time and vectorize.
+		/// The swarm is evaluated as one batch by FuncInterface::EvaluateParallel
+		template<size_t dim>
+		class ParticleSwarm
+		{
+		public:
+			static PointVal<dim> Proceed(ConcreteState::StateParticleSwarm<dim>& State, const FuncInterface::IFunc<dim>* f)
+			{
+				Propose(State);
+				State.Evaluate(f, State.X, State.FX.data());
+				return Select(State);
+			}
+
+			/// @brief Moves the particles
+			static void Propose(ConcreteState::StateParticleSwarm<dim>& State)
+			{
+				const size_t n = State.Size();
+				const double w = State.W;
+				const double c1 = State.C1;
+				const double c2 = State.C2;
+				const Point<dim> g{ State.Guess().P };
+
+				Random::FillUniform32(State.Rng, State.R.data(), State.R.size());
+
+				for (size_t i = 0; i < dim; ++i)
+				{
+					double* x = State.X.Axis(i);
+					double* v = State.Velocity.Axis(i);
+					const double* p = State.Best.Axis(i);
+					const double* r1 = State.R.data() + i * n;
+					const double* r2 = State.R.data() + (dim + i) * n;
+					const double gi = g[i];
+					const double vmax = State.VMax[i];
+#pragma omp simd
+					for (size_t k = 0; k < n; ++k)
+					{
+						double vk = w * v[k] + c1 * r1[k] * (p[k] - x[k]) + c2 * r2[k] * (gi - x[k]);
+						vk = std::min(std::max(vk, -vmax), vmax);
+						v[k] = vk;
+						x[k] += vk;
+					}
+					State.Clamp(i, x, n);
+				}
+
+			}
+
+			/// @brief Updates the personal and the global bests after the particles are evaluated
+			static PointVal<dim> Select(ConcreteState::StateParticleSwarm<dim>& State)
+			{
+				const size_t n = State.Size();
+				const double* fx = State.FX.data();
+				double* fb = State.FBest.data();
+				for (size_t i = 0; i < dim; ++i)
+				{
+					const double* x = State.X.Axis(i);
+					double* p = State.Best.Axis(i);
+#pragma omp simd
+					for (size_t k = 0; k < n; ++k)
+						p[k] = fx[k] < fb[k] ? x[k] : p[k];
+				}
+#pragma omp simd
+				for (size_t k = 0; k < n; ++k)
+					fb[k] = fx[k] < fb[k] ? fx[k] : fb[k];
+
+				State.UpdateState(State.Best, State.FBest);
+				return State.Guess();
+			}
+		};
+	} // ConcreteOptimizer
+
+	namespace StateParams
+	{
+		template<size_t dim>
+		struct ParticleSwarmParams
+		{
+		public:
+			using OptAlgo = OptLib::ConcreteOptimizer::ParticleSwarm<dim>;
+			using StateType = ConcreteState::StateParticleSwarm<dim>;
+
+		public:
+			Point<dim> Lower;
+			Point<dim> Upper;
+			/// @param vmax The largest speed as a fraction of the box
+			ParticleSwarmParams(Point<dim>&& lower, Point<dim>&& upper, size_t size,
+				double w = 0.7298, double c1 = 1.49618, double c2 = 1.49618, double vmax = 0.2, std::uint64_t seed = 0)
+				:Lower{ std::move(lower) }, Upper{ std::move(upper) }, size{ size }, w{ w }, c1{ c1 }, c2{ c2 }, vmax{ vmax }, seed{ seed }
+			{}
+			StateType CreateState(FuncInterface::IFunc<dim>* f)
+			{
+				return { std::move(Lower), std::move(Upper), f, size, w, c1, c2, vmax, seed };
+			}
+
+		protected:
+			size_t size;
+			double w;
+			double c1;
+			double c2;
+			double vmax;
+			std::uint64_t seed;
+		};
+	} // StateParams
+
+	namespace ConcreteOptimizer
+	{
+		/// @brief Particle swarm optimization as an ask/tell state machine, see OptimizerInterface::AskTell. Every step asks for the moved swarm
+		template<size_t dim>
+		class ParticleSwarmAskTell : public OptimizerInterface::AskTell<ParticleSwarmAskTell<dim>, StateParams::ParticleSwarmParams<dim>>
+		{
+			using Base = OptimizerInterface::AskTell<ParticleSwarmAskTell<dim>, StateParams::ParticleSwarmParams<dim>>;
+			friend Base;
+
+		public:
+			using Base::Base;
+
+		protected:
+			void Propose(std::vector<Point<dim>>& out)
+			{
+				auto& State = *this->ItsState;
+				ParticleSwarm<dim>::Propose(State);
+				out = State.Gather(State.X);
+			}
+
+			void Complete(const double* v)
+			{
+				auto& State = *this->ItsState;
+				std::copy(v, v + State.Size(), State.FX.begin());
+				ParticleSwarm<dim>::Select(State);
+			}
+		};
+	} // ConcreteOptimizer
+} // OptLib
+
+#endif
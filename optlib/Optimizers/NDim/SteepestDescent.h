@@ -0,0 +1,128 @@
+#ifndef STEEPESTDESCENT_H
+#define STEEPESTDESCENT_H
+
+#include "../../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../../Points/SetOfPoints/PointVals/Point/PointOperators.h"
+#include "../../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../../Points/SetOfPoints/PointVals/PointValOperators.h"
+
+#include "../../Functions/Interface/FuncInterface.h"
+#include "../../Functions/FuncAlongGradDirection.h"
+
+#include "../../States/State.h"
+
+#include "../OneDim/LineSearch.h"
+#include "../OneDim/GoldenSection.h"
+
+namespace OptLib
+{
+	namespace ConcreteState
+	{
+		/// @brief State of 1st order methods with a line search.
+		/// Only the current point, its gradient and the last step are stored, i.e., O(dim) memory
+		template<size_t dim>
+		class StateGradient : public StatePoint<dim>
+		{
+		protected:
+			using Base = StatePoint<dim>;
+
+			Grad<dim> ItsGrad;
+			double ItsStep;
+
+		public:
+			constexpr static const char* CheckpointTag = "Gradient";
+			using func_type = FuncInterface::IFuncWithGrad<dim>;
+			using Base::Guess;
+
+			// settings of the inner 1D search
+			const size_t LineIter;
+			const double LineTol;
+
+			StateGradient(Point<dim>&& x0, const func_type* f, double step0, size_t lineIter, double lineTol) :
+				Base{ FuncInterface::CreateFromPoint<dim>(std::move(x0), f) },
+				ItsGrad{ f->grad(Guess().P) },
+				ItsStep{ step0 },
+				LineIter{ lineIter },
+				LineTol{ lineTol }
+			{}
+
+			const Grad<dim>& Gradient() const { return ItsGrad; }
+			/// @brief Step accepted by the last line search. It defines the bracket of the next one
+			double Step() const { return ItsStep; }
+
+			using Base::UpdateState;
+			void UpdateState(const PointVal<dim>& v, Grad<dim>&& g, double step)
+			{
+				UpdateState(v); // the virtual call, so StateWithMemory::StatePointMemory sees the move
+				ItsGrad = std::move(g);
+				ItsStep = step;
+			}
+
+			template<typename archive>
+			void Serialize(archive& ar)
+			{
+				Base::Serialize(ar);
+				ar(ItsGrad, ItsStep);
+			}
+		};
+	} // ConcreteState
+
+	namespace ConcreteOptimizer
+	{
+		/// @brief Steepest descent with the step chosen by a 1D method along FuncAlongGradDirection
+		/// @tparam lineParams Parameters of the 1D method used as a line search
+		template<size_t dim, typename lineParams = StateParams::GoldenSectionParams>
+		class SteepestDescent
+		{
+		public:
+			static PointVal<dim> Proceed(ConcreteState::StateGradient<dim>& State, const FuncInterface::IFuncWithGrad<dim>* f)
+			{
+				const PointVal<dim> x{ State.Guess() };
+				ConcreteFunc::FuncAlongGradDirection<dim> phi{ f, x.P, State.Gradient() };
+
+				// phi(0) = f(x) is known, the trial step is twice the previous one
+				PointVal<1> best{ LineSearch<lineParams>::Search(
+					&phi, PointVal<1>{ Point<1>{ 0.0 }, x.Val }, 2.0 * State.Step(), State.LineIter, State.LineTol) };
+
+				if (!(best.Val < x.Val))
+				{ // no descent is possible, dx == 0 means convergence
+					State.UpdateState(x);
+					return State.Guess();
+				}
+
+				Point<dim> xNew{ phi.PointAt(best.P[0]) };
+				Grad<dim> g{ f->grad(xNew) };
+				State.UpdateState(PointVal<dim>{ std::move(xNew), best.Val }, std::move(g), best.P[0]);
+				return State.Guess();
+			}
+		};
+	} // ConcreteOptimizer
+
+	namespace StateParams
+	{
+		template<size_t dim, typename lineParams = GoldenSectionParams>
+		struct SteepestDescentParams
+		{
+		public:
+			using OptAlgo = OptLib::ConcreteOptimizer::SteepestDescent<dim, lineParams>;
+			using StateType = ConcreteState::StateGradient<dim>;
+
+		public:
+			Point<dim> StartPoint;
+			SteepestDescentParams(Point<dim>&& sop, double step0 = 1.0E-2, size_t lineIter = 40, double lineTol = 1.0E-10)
+				:StartPoint{ std::move(sop) }, step0{ step0 }, lineIter{ lineIter }, lineTol{ lineTol }
+			{}
+			StateType CreateState(FuncInterface::IFuncWithGrad<dim>* f)
+			{
+				return { std::move(StartPoint), f, step0, lineIter, lineTol };
+			}
+
+		protected:
+			double step0;
+			size_t lineIter;
+			double lineTol;
+		};
+	} // StateParams
+} // OptLib
+
+#endif
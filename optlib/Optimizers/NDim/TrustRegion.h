@@ -0,0 +1,366 @@
+#ifndef TRUSTREGION_H
+#define TRUSTREGION_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+#include "../../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../../Points/SetOfPoints/PointVals/Point/PointOperators.h"
+#include "../../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../../Points/SetOfPoints/PointVals/PointValOperators.h"
+
+#include "../../Functions/Interface/FuncInterface.h"
+
+#include "../../States/State.h"
+
+namespace OptLib
+{
+	namespace ConcreteState
+	{
+		/// @brief Dense linear algebra of the trust-region subproblems, dim is small and known at compile time
+		namespace TrustRegionDetail
+		{
+			template<size_t dim>
+			double Dot(const Point<dim>& a, const Point<dim>& b)
+			{
+				double s = 0.0;
+				for (size_t i = 0; i < dim; ++i)
+					s += a[i] * b[i];
+				return s;
+			}
+
+			template<size_t dim>
+			Point<dim> Mul(const Hess<dim>& H, const Point<dim>& v)
+			{
+				Point<dim> out;
+				for (size_t i = 0; i < dim; ++i)
+					out[i] = Dot<dim>(H[i], v);
+				return out;
+			}
+
+			/// @brief tau >= 0 such that |p + tau d| = radius for |p| <= radius
+			template<size_t dim>
+			double ToBoundary(const Point<dim>& p, const Point<dim>& d, double radius)
+			{
+				const double a = Dot<dim>(d, d);
+				const double b = Dot<dim>(p, d);
+				const double c = Dot<dim>(p, p) - radius * radius;
+				if (a == 0.0) return 0.0;
+				return (-b + std::sqrt(std::max(b * b - a * c, 0.0))) / a;
+			}
+		} // TrustRegionDetail
+
+		/// @brief Dogleg step between the Cauchy point and the Newton step.
+		/// H is factorized by Cholesky once per point: a shrinking radius only moves the point along the same path.
+		/// If H is not positive definite the path is the steepest descent only
+		template<size_t dim>
+		class DoglegStep
+		{
+		public:
+			constexpr static const char* CheckpointTag = "Dogleg";
+			void Build(const Grad<dim>& g, const Hess<dim>& H, double)
+			{
+				using namespace TrustRegionDetail;
+				const double gg = Dot<dim>(g, g);
+				const double gHg = Dot<dim>(g, Mul<dim>(H, g));
+				Descent = -1.0 * g;
+				Curved = gHg > 0.0;
+				if (Curved)
+					Cauchy = (gg / gHg) * Descent;
+				PositiveDefinite = Cholesky(H, g);
+			}
+
+			Point<dim> Step(double radius) const
+			{
+				using namespace TrustRegionDetail;
+				const double gn = std::sqrt(Dot<dim>(Descent, Descent));
+				if (gn == 0.0)
+					return Descent;
+				if (!Curved) // negative curvature along the gradient, the model decreases up to the boundary
+					return (radius / gn) * Descent;
+
+				const double cn = std::sqrt(Dot<dim>(Cauchy, Cauchy));
+				if (cn >= radius)
+					return (radius / cn) * Cauchy;
+				if (!PositiveDefinite)
+					return Cauchy;
+				if (Dot<dim>(Newton, Newton) <= radius * radius)
+					return Newton;
+				Point<dim> d{ Newton - Cauchy };
+				return Cauchy + ToBoundary<dim>(Cauchy, d, radius) * d;
+			}
+
+			template<typename archive>
+			void Serialize(archive& ar) { ar(Descent, Cauchy, Newton, Curved, PositiveDefinite); }
+
+		protected:
+			Point<dim> Descent;
+			Point<dim> Cauchy;
+			Point<dim> Newton;
+			bool Curved{ false };
+			bool PositiveDefinite{ false };
+
+			/// @brief Solves H p = -g by H = L L^T. False if H is not positive definite
+			bool Cholesky(const Hess<dim>& H, const Grad<dim>& g)
+			{
+				std::array<std::array<double, dim>, dim> L{};
+				for (size_t j = 0; j < dim; ++j)
+				{
+					double s = H[j][j];
+					for (size_t k = 0; k < j; ++k)
+						s -= L[j][k] * L[j][k];
+					if (!(s > 0.0)) return false;
+					L[j][j] = std::sqrt(s);
+					for (size_t i = j + 1; i < dim; ++i)
+					{
+						double t = H[i][j];
+						for (size_t k = 0; k < j; ++k)
+							t -= L[i][k] * L[j][k];
+						L[i][j] = t / L[j][j];
+					}
+				}
+				Point<dim> y;
+				for (size_t i = 0; i < dim; ++i)
+				{
+					double t = -g[i];
+					for (size_t k = 0; k < i; ++k)
+						t -= L[i][k] * y[k];
+					y[i] = t / L[i][i];
+				}
+				for (size_t i = dim; i-- > 0;)
+				{
+					double t = y[i];
+					for (size_t k = i + 1; k < dim; ++k)
+						t -= L[k][i] * Newton[k];
+					Newton[i] = t / L[i][i];
+				}
+				return true;
+			}
+		};
+
+		/// @brief Truncated conjugate gradients of Steihaug (1983). Only products H v are used.
+		/// The iterates grow in norm monotonically, so the path built for a radius contains the solution
+		/// for every smaller radius: after a rejected step the new point is found on the stored path
+		/// without any product with H
+		template<size_t dim>
+		class SteihaugStep
+		{
+		public:
+			constexpr static const char* CheckpointTag = "Steihaug";
+			void Build(const Grad<dim>& g, const Hess<dim>& H, double radius)
+			{
+				using namespace TrustRegionDetail;
+				Path.assign(1, Point<dim>{});
+
+				Point<dim> z{ Path.front() };
+				Point<dim> r{ g };
+				Point<dim> d{ -1.0 * g };
+				double rr = Dot<dim>(r, r);
+				const double gn = std::sqrt(rr);
+				// forcing sequence of the inexact Newton method, superlinear convergence
+				const double tol = std::min(0.5, std::sqrt(gn)) * gn;
+				if (gn == 0.0) return;
+
+				for (size_t j = 0; j < 2 * dim; ++j)
+				{
+					Point<dim> Hd{ Mul<dim>(H, d) };
+					const double dHd = Dot<dim>(d, Hd);
+					if (dHd <= 0.0)
+					{ // negative curvature, go to the boundary
+						Path.push_back(z + ToBoundary<dim>(z, d, radius) * d);
+						return;
+					}
+					const double alpha = rr / dHd;
+					Point<dim> zn{ z + alpha * d };
+					if (Dot<dim>(zn, zn) >= radius * radius)
+					{
+						Path.push_back(z + ToBoundary<dim>(z, d, radius) * d);
+						return;
+					}
+					Path.push_back(zn);
+					r = r + alpha * Hd;
+					const double rrn = Dot<dim>(r, r);
+					if (std::sqrt(rrn) < tol) return;
+					d = (rrn / rr) * d - r;
+					rr = rrn;
+					z = zn;
+				}
+			}
+
+			Point<dim> Step(double radius) const
+			{
+				using namespace TrustRegionDetail;
+				for (size_t j = 1; j < Path.size(); ++j)
+					if (Dot<dim>(Path[j], Path[j]) > radius * radius)
+					{
+						Point<dim> d{ Path[j] - Path[j - 1] };
+						return Path[j - 1] + ToBoundary<dim>(Path[j - 1], d, radius) * d;
+					}
+				return Path.back();
+			}
+
+			/// @brief The path is kept rather than rebuilt: it depends on the radius it was built for
+			template<typename archive>
+			void Serialize(archive& ar) { ar(Path); }
+
+		protected:
+			std::vector<Point<dim>> Path; // the CG iterates z_0 = 0, z_1, ..., the last one may be on the boundary
+		};
+
+		/// @brief State of the trust-region Newton method: the point with its gradient and Hessian,
+		/// the radius of the region and the solver of the subproblem, which is kept while the point does not move
+		template<size_t dim, typename subproblem = SteihaugStep<dim>>
+		class StateTrustRegion : public StatePoint<dim>
+		{
+		protected:
+			using Base = StatePoint<dim>;
+			using Base::dx;
+
+			Grad<dim> ItsGrad;
+			Hess<dim> ItsHess;
+			double ItsRadius;
+			bool Fresh{ false }; // Sub is built for the current point
+
+		public:
+			constexpr static const char* CheckpointTag = "TrustRegion";
+			using CheckpointParts = std::tuple<subproblem>;
+			using func_type = FuncInterface::IFuncWithHess<dim>;
+			using Base::Guess;
+
+			const double MaxRadius;
+			// the step is accepted if the actual reduction is at least Eta of the predicted one
+			const double Eta;
+			subproblem Sub;
+
+			StateTrustRegion(Point<dim>&& x0, const func_type* f, double radius, double maxRadius, double eta) :
+				Base{ FuncInterface::CreateFromPoint<dim>(std::move(x0), f) },
+				ItsGrad{ f->grad(Guess().P) },
+				ItsHess{ f->hess(Guess().P) },
+				ItsRadius{ radius },
+				MaxRadius{ maxRadius },
+				Eta{ eta }
+			{}
+
+			const Grad<dim>& Gradient() const { return ItsGrad; }
+			const Hess<dim>& Hessian() const { return ItsHess; }
+			double Radius() const { return ItsRadius; }
+
+			/// @brief Minimizer of the quadratic model in the current region
+			Point<dim> Step()
+			{
+				if (!Fresh)
+				{
+					Sub.Build(ItsGrad, ItsHess, ItsRadius);
+					Fresh = true;
+				}
+				return Sub.Step(ItsRadius);
+			}
+
+			/// @brief Decrease of the quadratic model along p
+			double Predicted(const Point<dim>& p) const
+			{
+				using namespace ConcreteState::TrustRegionDetail;
+				return -(Dot<dim>(ItsGrad, p) + 0.5 * Dot<dim>(p, Mul<dim>(ItsHess, p)));
+			}
+
+			void SetRadius(double r) { ItsRadius = std::min(r, MaxRadius); }
+
+			using Base::UpdateState;
+			/// @brief Moves to an accepted point
+			void UpdateState(const PointVal<dim>& v, Grad<dim>&& g, Hess<dim>&& H)
+			{
+				UpdateState(v);
+				ItsGrad = std::move(g);
+				ItsHess = std::move(H);
+				Fresh = false;
+			}
+
+			/// @brief Keeps the point after a rejected step p. The convergence is measured by the rejected step,
+			/// which shrinks with the radius
+			void Reject(const Point<dim>& p, double predicted)
+			{
+				dx = PointVal<dim>{ abs(p), std::abs(predicted) };
+			}
+
+			template<typename archive>
+			void Serialize(archive& ar)
+			{
+				Base::Serialize(ar);
+				ar(ItsGrad, ItsHess, ItsRadius, Fresh, Sub);
+			}
+		};
+	} // ConcreteState
+
+	namespace ConcreteOptimizer
+	{
+		/// @brief Newton method globalized by a trust region (Nocedal, Wright, 2006, ch. 4).
+		/// The ratio rho of the actual and the predicted reductions shrinks the radius if rho < 1/4 and expands it
+		/// if rho > 3/4 and the step reaches the boundary. A step is accepted if rho > Eta, a rejected step always shrinks the radius.
+		/// A rejected step costs one evaluation of f: the gradient, the Hessian and the subproblem solver are reused
+		/// @tparam subproblem SteihaugStep (default) or DoglegStep
+		template<size_t dim, typename subproblem = ConcreteState::SteihaugStep<dim>>
+		class TrustRegion
+		{
+		public:
+			static PointVal<dim> Proceed(ConcreteState::StateTrustRegion<dim, subproblem>& State, const FuncInterface::IFuncWithHess<dim>* f)
+			{
+				const PointVal<dim> x{ State.Guess() };
+				Point<dim> p{ State.Step() };
+				const double pred = State.Predicted(p);
+				if (!(pred > 0.0))
+				{ // the gradient vanishes, dx == 0 means convergence
+					State.UpdateState(x);
+					return State.Guess();
+				}
+
+				PointVal<dim> y{ FuncInterface::CreateFromPoint<dim>(x.P + p, f) };
+				const double rho = (x.Val - y.Val) / pred;
+				const double pn = std::sqrt(ConcreteState::TrustRegionDetail::Dot<dim>(p, p));
+
+				const bool accepted = rho > State.Eta;
+				if (!accepted || !(rho >= 0.25)) // NaN shrinks as well, the same step is not tried again for Eta > 1/4
+					State.SetRadius(0.25 * pn);
+				else if (rho > 0.75 && pn > 0.99 * State.Radius())
+					State.SetRadius(2.0 * State.Radius());
+
+				if (accepted)
+					State.UpdateState(y, f->grad(y.P), f->hess(y.P));
+				else
+					State.Reject(p, pred);
+				return State.Guess();
+			}
+		};
+	} // ConcreteOptimizer
+
+	namespace StateParams
+	{
+		/// @tparam subproblem ConcreteState::SteihaugStep<dim> (default) or ConcreteState::DoglegStep<dim>
+		template<size_t dim, typename subproblem = ConcreteState::SteihaugStep<dim>>
+		struct TrustRegionParams
+		{
+		public:
+			using OptAlgo = OptLib::ConcreteOptimizer::TrustRegion<dim, subproblem>;
+			using StateType = ConcreteState::StateTrustRegion<dim, subproblem>;
+
+		public:
+			Point<dim> StartPoint;
+			TrustRegionParams(Point<dim>&& sop, double radius = 1.0, double maxRadius = 100.0, double eta = 0.1)
+				:StartPoint{ std::move(sop) }, radius{ radius }, maxRadius{ maxRadius }, eta{ eta }
+			{}
+			StateType CreateState(FuncInterface::IFuncWithHess<dim>* f)
+			{
+				return { std::move(StartPoint), f, radius, maxRadius, eta };
+			}
+
+		protected:
+			double radius;
+			double maxRadius;
+			double eta;
+		};
+	} // StateParams
+} // OptLib
+
+#endif
@@ -0,0 +1,227 @@
+#ifndef OBSERVERS_H
+#define OBSERVERS_H
+
+#include <algorithm>
+#include <chrono>
+#include <ostream>
+#include <tuple>
+#include <utility>
+
+#include "../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../Points/SetOfPoints/PointVals/PointValOperators.h"
+#include "../States/StateWithMemory.h"
+
+namespace OptLib
+{
+	/// @brief Observer policies of Optimizer, its second template parameter. An observer is any class with any subset of the hooks
+	///		void Started(size_t done, const state&)          before the first iteration of Optimize, done iterations so far
+	///		void IterationStarted(size_t it)                 before the it-th iteration, it counts from 1
+	///		void Evaluated(size_t calls, size_t total)       calls of f in the iteration and so far, only if f is a FunctWithCounter::ICounterFunc.
+	///		                                                 Also called before Started with calls == 0 and the calls made before the run
+	///		void Updated(size_t it, const state&)            after the state has been updated by the iteration
+	///		void IterationEnded(size_t it)                   after the iteration and the test of the convergence
+	///		void Converged(size_t it, const state&)          when the state has converged, before Stopped
+	///		void Stopped(size_t done, const state&)          when Optimize stops for any reason, see Optimizer::Reason
+	/// The hooks that are missing are not called, so the calls of None compile away, and f is not even asked for its counter
+	/// unless Evaluated is present. The hooks run on the thread of the loop, i.e., on the executor for OptimizeAsync
+	namespace Observers
+	{
+		/// @brief No hooks, the default of Optimizer
+		struct None {};
+
+		/// @brief Counts the iterations, the evaluations and the improvements of the guess
+		struct Counters
+		{
+			size_t Runs{ 0 };
+			size_t Iterations{ 0 };
+			// the total reported by f, 0 if f does not count
+			size_t Evaluations{ 0 };
+			// updates that decreased the value of the guess
+			size_t Improvements{ 0 };
+			bool HasConverged{ false };
+
+			template<typename state>
+			void Started(size_t, const state& State)
+			{
+				++Runs;
+				HasConverged = false;
+				Best = State.Guess().Val;
+			}
+			void IterationStarted(size_t) { ++Iterations; }
+			void Evaluated(size_t, size_t total) { Evaluations = total; }
+			template<typename state>
+			void Updated(size_t, const state& State)
+			{
+				const double v = State.Guess().Val;
+				if (v < Best)
+				{
+					++Improvements;
+					Best = v;
+				}
+			}
+			template<typename state>
+			void Converged(size_t, const state&) { HasConverged = true; }
+
+		protected:
+			double Best{ 0.0 };
+		};
+
+		/// @brief Wall time of the iterations by the monotonic clock, read twice per iteration
+		struct Timing
+		{
+			using clock = std::chrono::steady_clock;
+
+			size_t Iterations{ 0 };
+			clock::duration Total{ 0 };
+			clock::duration Max{ 0 };
+
+			clock::duration Mean() const { return Iterations > 0 ? Total / static_cast<long>(Iterations) : clock::duration{ 0 }; }
+
+			void IterationStarted(size_t) { Begin = clock::now(); }
+			void IterationEnded(size_t)
+			{
+				const clock::duration d = clock::now() - Begin;
+				++Iterations;
+				Total += d;
+				Max = std::max(Max, d);
+			}
+
+		protected:
+			clock::time_point Begin{};
+		};
+
+		/// @brief Keeps every Stride-th state of the run in a StateWithMemory::Trajectory, the start included.
+		/// The records are numbered by the iterations of Optimizer
+		/// @tparam count 1 for the guess of a point state, dim + 1 for the domain of a simplex state
+		template<size_t dim, size_t count = 1>
+		class SampledTrajectory
+		{
+		public:
+			using memory_type = StateWithMemory::Trajectory<dim, count>;
+
+			explicit SampledTrajectory(size_t capacity, size_t stride = 1, StateWithMemory::Overflow policy = StateWithMemory::Overflow::Decimate) :
+				ItsMemory{ capacity, policy, stride }
+			{}
+
+			const memory_type& Memory() const { return ItsMemory; }
+
+			template<typename state>
+			void Started(size_t done, const state& State)
+			{
+				if (ItsMemory.Updates() == 0) // a continued run has recorded its start already
+					Record(done, State);
+			}
+			void Evaluated(size_t, size_t total) { Evals = total; }
+			template<typename state>
+			void Updated(size_t it, const state& State) { Record(it, State); }
+
+		protected:
+			memory_type ItsMemory;
+			size_t Evals{ 0 };
+
+			template<typename state>
+			void Record(size_t it, const state& State)
+			{
+				typename memory_type::record_type r;
+				r.Iteration = it;
+				r.Evaluations = Evals;
+				if constexpr (count == 1)
+					r.Points = SetOfPoints<1, PointVal<dim>>{ State.Guess() };
+				else
+					r.Points = State.GuessDomain();
+				ItsMemory.Record(r);
+			}
+		};
+
+		/// @brief Prints the guess after every iteration and a summary at the end, e.g., Trace{ std::clog }
+		class Trace
+		{
+		public:
+			explicit Trace(std::ostream& out) : Out{ &out } {}
+
+			template<typename state>
+			void Started(size_t, const state&) { *Out << "Optimization started...\n"; }
+			template<typename state>
+			void Updated(size_t, const state& State) { *Out << "Current state: " << State.Guess() << '\n'; }
+			template<typename state>
+			void Stopped(size_t done, const state& State)
+			{
+				*Out << "Optimization ended\n";
+				*Out << "Total number of iterations is s = " << done << '\n';
+				*Out << "Final guess is x = " << State.Guess() << '\n';
+			}
+
+		protected:
+			std::ostream* Out;
+		};
+
+		template<typename T>
+		concept Evaluates = requires (T& o, size_t n) { o.Evaluated(n, n); };
+
+		/// @brief Calls the hooks of several observers in their order, e.g., Chain<Counters, Timing>
+		template<typename... observer>
+		class Chain
+		{
+		public:
+			Chain() = default;
+			explicit Chain(observer... obs) : Parts{ std::move(obs)... } {}
+
+			template<size_t i>
+			auto& Get() { return std::get<i>(Parts); }
+			template<size_t i>
+			const auto& Get() const { return std::get<i>(Parts); }
+			template<typename T>
+			T& Get() { return std::get<T>(Parts); }
+			template<typename T>
+			const T& Get() const { return std::get<T>(Parts); }
+
+			template<typename state>
+			void Started(size_t done, const state& State)
+			{
+				std::apply([&](auto&... o) { (Call(o, [&](auto& x) -> decltype(x.Started(done, State)) { x.Started(done, State); }), ...); }, Parts);
+			}
+			void IterationStarted(size_t it)
+			{
+				std::apply([&](auto&... o) { (Call(o, [&](auto& x) -> decltype(x.IterationStarted(it)) { x.IterationStarted(it); }), ...); }, Parts);
+			}
+			// only present if a part needs it, see the hooks above
+			void Evaluated(size_t calls, size_t total)
+				requires (Evaluates<observer> || ...)
+			{
+				std::apply([&](auto&... o) { (Call(o, [&](auto& x) -> decltype(x.Evaluated(calls, total)) { x.Evaluated(calls, total); }), ...); }, Parts);
+			}
+			template<typename state>
+			void Updated(size_t it, const state& State)
+			{
+				std::apply([&](auto&... o) { (Call(o, [&](auto& x) -> decltype(x.Updated(it, State)) { x.Updated(it, State); }), ...); }, Parts);
+			}
+			void IterationEnded(size_t it)
+			{
+				std::apply([&](auto&... o) { (Call(o, [&](auto& x) -> decltype(x.IterationEnded(it)) { x.IterationEnded(it); }), ...); }, Parts);
+			}
+			template<typename state>
+			void Converged(size_t it, const state& State)
+			{
+				std::apply([&](auto&... o) { (Call(o, [&](auto& x) -> decltype(x.Converged(it, State)) { x.Converged(it, State); }), ...); }, Parts);
+			}
+			template<typename state>
+			void Stopped(size_t done, const state& State)
+			{
+				std::apply([&](auto&... o) { (Call(o, [&](auto& x) -> decltype(x.Stopped(done, State)) { x.Stopped(done, State); }), ...); }, Parts);
+			}
+
+		protected:
+			std::tuple<observer...> Parts;
+
+			/// @brief Calls the hook of x if x has it
+			template<typename T, typename hook>
+			static void Call(T& x, hook&& Hook)
+			{
+				if constexpr (requires { Hook(x); })
+					Hook(x);
+			}
+		};
+	} // Observers
+} // OptLib
+
+#endif
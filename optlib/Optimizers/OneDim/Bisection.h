@@ -4,6 +4,7 @@
 #include "../../Points/SetOfPoints/PointVals/Point/Point.h"
 #include "../../Points/SetOfPoints/PointVals/PointVal.h"
 #include "../../Points/SetOfPoints/SetOfPoints.h"
+#include "../../Points/SetOfPoints/Selection.h"
 #include "../../Points/Definitions.h"
 
 #include "../../Functions/Interface/FuncInterface.h"
@@ -21,11 +22,33 @@ namespace OptLib
 		class StateBisection : public StateSegment
 		{
 		public:
+			constexpr static const char* CheckpointTag = "Bisection";
 			SetOfPoints<5, PointVal<1>> AuxPoints;
 
 			StateBisection(Simplex<1>&& State, FuncInterface::IFunc<1>* f)
 				:
 				StateSegment(std::move(State), f)
+			{
+				InitAuxPoints(f);
+			}
+
+			/// @brief The end points of the segment are already evaluated and are not recalculated
+			StateBisection(SimplexVal<1>&& State, FuncInterface::IFunc<1>* f)
+				:
+				StateSegment(std::move(State))
+			{
+				InitAuxPoints(f);
+			}
+
+			template<typename archive>
+			void Serialize(archive& ar)
+			{
+				StateSegment::Serialize(ar);
+				ar(AuxPoints);
+			}
+
+		protected:
+			void InitAuxPoints(FuncInterface::IFunc<1>* f)
 			{
 				AuxPoints[0] = this->GuessDomain()[0];
 				AuxPoints[4] = this->GuessDomain()[1];
@@ -50,8 +73,7 @@ namespace OptLib
 			{
 				SetOfPoints<5, PointVal<1>>& AuxPoints = State.AuxPoints;
 
-				SetOfPoints<5, PointVal<1>>::iterator min = std::min_element(AuxPoints.begin(), AuxPoints.end());
-				size_t pos = std::distance(AuxPoints.begin(), min);
+				size_t pos = Selection::ArgMin(AuxPoints);
 
 				if (pos == 0)
 				{// keep AuxPoints[0]
@@ -109,6 +131,26 @@ namespace OptLib
 			}
 		};
 	} // Optimizer
+
+	namespace StateParams
+	{
+		struct BisectionParams
+		{
+		public:
+			using OptAlgo = OptLib::ConcreteOptimizer::Bisection;
+			using StateType = ConcreteState::StateBisection;
+
+		public:
+			SetOfPoints<2, Point<1>> StartSegment;
+			BisectionParams(SetOfPoints<2, Point<1>>&& sop)
+				:StartSegment{ std::move(sop) }
+			{}
+			StateType CreateState(FuncInterface::IFunc<1>* f)
+			{
+				return { std::move(StartSegment), f };
+			}
+		};
+	} // StateParams
 } // OptLib
 
 #endif
\ No newline at end of file
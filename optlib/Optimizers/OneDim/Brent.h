@@ -0,0 +1,191 @@
+#ifndef BRENT_H
+#define BRENT_H
+
+#include <cmath>
+
+#include "../../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../../Points/SetOfPoints/PointVals/Point/PointOperators.h"
+#include "../../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../../Points/SetOfPoints/SetOfPoints.h"
+
+#include "../../Functions/Interface/FuncInterface.h"
+
+#include "../../States/State.h"
+
+namespace OptLib
+{
+	namespace ConcreteState
+	{
+		/// @brief State of the Brent method. The segment [a, b] always contains the best point X.
+		/// W is the second best point, V is the previous value of W. The guess is X rather than the middle of the segment
+		class StateBrent : public StateSegment
+		{
+		public:
+			constexpr static const char* CheckpointTag = "Brent";
+			PointVal<1> X{};
+			PointVal<1> W{};
+			PointVal<1> V{};
+			double d{ 0.0 }; // the last step
+			double e{ 0.0 }; // the step before the last one
+			const double resphi{ (3.0 - std::sqrt(5.0)) / 2.0 };
+			// relative resolution of the steps, steps shorter than Tol * |X| + ZEps are not taken
+			const double Tol;
+			const double ZEps{ 1.0E-12 };
+
+			StateBrent(SetOfPoints<2, OptLib::Point<1>>&& State, FuncInterface::IFunc<1>* f, double tol = 1.0E-8)
+				:
+				StateSegment(std::move(State), f),
+				Tol{ tol }
+			{
+				InitAuxPoints(f);
+			}
+
+			/// @brief The end points of the segment are already evaluated and are not recalculated
+			StateBrent(SimplexVal<1>&& State, FuncInterface::IFunc<1>* f, double tol = 1.0E-8)
+				:
+				StateSegment(std::move(State)),
+				Tol{ tol }
+			{
+				InitAuxPoints(f);
+			}
+
+			/// @brief The segment is small compared with X or the resolution Tol of the method is reached
+			bool IsConverged(double abs_tol, double rel_tol) const override
+			{
+				const double a = GuessDomain()[0][0];
+				const double b = GuessDomain()[1][0];
+				const double half = (b - a) / 2.0;
+				const double tol2 = 2.0 * (Tol * std::abs(X[0]) + ZEps);
+				return half < abs_tol || half < rel_tol * std::abs(X[0]) ||
+					std::abs(X[0] - (a + b) / 2.0) <= tol2 - half;
+			}
+
+			void SetDomain(SimplexVal<1>&& newDomain) override
+			{
+				StateSegment::SetDomain(std::move(newDomain));
+				ItsGuess = X;
+			}
+
+			template<typename archive>
+			void Serialize(archive& ar)
+			{
+				StateSegment::Serialize(ar);
+				ar(X, W, V, d, e);
+			}
+
+		protected:
+			void InitAuxPoints(FuncInterface::IFunc<1>* f)
+			{
+				const auto& a = GuessDomain()[0];
+				const auto& b = GuessDomain()[1];
+				X = FuncInterface::CreateFromPoint<1>(a.P + resphi * (b.P - a.P), f);
+				W = X;
+				V = X;
+				ItsGuess = X;
+			}
+		};
+	} // ConcreteState
+
+	namespace ConcreteOptimizer
+	{
+		/// @brief Brent minimization: successive parabolic interpolation through X, W, V
+		/// with a golden section step whenever the parabola is not trusted. One evaluation per iteration.
+		/// The convergence is superlinear on smooth functions and never slower than the golden section
+		class Brent
+		{
+		public:
+			static PointVal<1> Proceed(ConcreteState::StateBrent& State, const FuncInterface::IFunc<1>* f)
+			{
+				PointVal<1> a{ State.GuessDomain()[0] };
+				PointVal<1> b{ State.GuessDomain()[1] };
+				auto& X = State.X;
+				auto& W = State.W;
+				auto& V = State.V;
+				double& d = State.d;
+				double& e = State.e;
+
+				const double x = X[0];
+				const double xm = (a[0] + b[0]) / 2.0;
+				const double tol1 = State.Tol * std::abs(x) + State.ZEps;
+				const double tol2 = 2.0 * tol1;
+
+				bool golden = true;
+				if (std::abs(e) > tol1)
+				{ // the parabola through X, W, V
+					double r = (x - W[0]) * (X.Val - V.Val);
+					double q = (x - V[0]) * (X.Val - W.Val);
+					double p = (x - V[0]) * q - (x - W[0]) * r;
+					q = 2.0 * (q - r);
+					if (q > 0.0) p = -p;
+					q = std::abs(q);
+					double eOld = e;
+					e = d;
+					// the parabolic step must be inside the segment and shorter than half of the step before last
+					if (std::abs(p) < std::abs(0.5 * q * eOld) && p > q * (a[0] - x) && p < q * (b[0] - x))
+					{
+						d = p / q;
+						double u = x + d;
+						if (u - a[0] < tol2 || b[0] - u < tol2)
+							d = std::copysign(tol1, xm - x);
+						golden = false;
+					}
+				}
+				if (golden)
+				{
+					e = (x >= xm ? a[0] : b[0]) - x;
+					d = State.resphi * e;
+				}
+
+				PointVal<1> u{ FuncInterface::CreateFromPoint<1>(
+					Point<1>{ std::abs(d) >= tol1 ? x + d : x + std::copysign(tol1, d) }, f) };
+
+				if (u.Val <= X.Val)
+				{
+					if (u[0] >= x) a = X; else b = X;
+					V = W;
+					W = X;
+					X = u;
+				}
+				else
+				{
+					if (u[0] < x) a = u; else b = u;
+					if (u.Val <= W.Val || W[0] == x)
+					{
+						V = W;
+						W = u;
+					}
+					else if (u.Val <= V.Val || V[0] == x || V[0] == W[0])
+						V = u;
+				}
+
+				State.SetDomain({ a, b });
+				return State.Guess();
+			}
+		};
+	} // ConcreteOptimizer
+
+	namespace StateParams
+	{
+		struct BrentParams
+		{
+		public:
+			using OptAlgo = OptLib::ConcreteOptimizer::Brent;
+			using StateType = ConcreteState::StateBrent;
+
+		public:
+			SetOfPoints<2, Point<1>> StartSegment;
+			BrentParams(SetOfPoints<2, Point<1>>&& sop, double tol = 1.0E-8)
+				:StartSegment{ std::move(sop) }, tol{ tol }
+			{}
+			StateType CreateState(FuncInterface::IFunc<1>* f)
+			{
+				return { std::move(StartSegment), f, tol };
+			}
+
+		protected:
+			double tol;
+		};
+	} // StateParams
+} // OptLib
+
+#endif
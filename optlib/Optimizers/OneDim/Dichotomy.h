@@ -1,9 +1,9 @@
 #ifndef DICHOTOMY_H
 #define DICHOTOMY_H
 
-#include "../../Points/SetOfPoints/PointVal/Point/Point.h"
-#include "../../Points/SetOfPoints/PointVal/Point/PointOperators.h"
-#include "../../Points/SetOfPoints/PointVal/PointVal.h"
+#include "../../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../../Points/SetOfPoints/PointVals/Point/PointOperators.h"
+#include "../../Points/SetOfPoints/PointVals/PointVal.h"
 #include "../../Points/SetOfPoints/SetOfPoints.h"
 
 #include "../../Functions/Interface/FuncInterface.h"
@@ -2,15 +2,17 @@
 #ifndef GOLDENSECTION_H
 #define GOLDENSECTION_H
 
-#include "../../Points/SetOfPoints/PointVal/Point/Point.h"
-#include "../../Points/SetOfPoints/PointVal/Point/PointOperators.h"
-#include "../../Points/SetOfPoints/PointVal/PointVal.h"
+#include "../../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../../Points/SetOfPoints/PointVals/Point/PointOperators.h"
+#include "../../Points/SetOfPoints/PointVals/PointVal.h"
 #include "../../Points/SetOfPoints/SetOfPoints.h"
 
 #include "../../Functions/Interface/FuncInterface.h"
 
 #include "../../States/State.h"
 
+#include "../AskTell.h"
+
 namespace OptLib
 {
 	namespace ConcreteState
@@ -21,6 +23,7 @@ namespace OptLib
 		class StateGoldenSection : public StateSegment
 		{
 		public:
+			constexpr static const char* CheckpointTag = "GoldenSection";
 			SetOfPoints<4, PointVal<1>> AuxPoints{};
 			double phi;
 			double resphi;
@@ -28,6 +31,27 @@ namespace OptLib
 			StateGoldenSection(SetOfPoints<2, OptLib::Point<1>>&& State, FuncInterface::IFunc<1>* f)
 				:
 				StateSegment(std::move(State), f)
+			{
+				InitAuxPoints(f);
+			}
+
+			/// @brief The end points of the segment are already evaluated and are not recalculated
+			StateGoldenSection(SimplexVal<1>&& State, FuncInterface::IFunc<1>* f)
+				:
+				StateSegment(std::move(State))
+			{
+				InitAuxPoints(f);
+			}
+
+			template<typename archive>
+			void Serialize(archive& ar)
+			{
+				StateSegment::Serialize(ar);
+				ar(AuxPoints, phi, resphi);
+			}
+
+		protected:
+			void InitAuxPoints(FuncInterface::IFunc<1>* f)
 			{
 				phi = (1 + std::sqrt(5)) / 2;
 				resphi = 2 - phi;
@@ -46,19 +70,36 @@ namespace OptLib
 		{
 		public:
 			static PointVal<1> Proceed(ConcreteState::StateGoldenSection& State, const FuncInterface::IFunc<1>* f)
+			{
+				size_t i = Shrink(State);
+				return Complete(State, i, (*f)(State.AuxPoints[i].P));
+			}
+
+			/// @brief Drops the end next to the worse inner point
+			/// @return The index of the new inner point in AuxPoints, which is not evaluated yet
+			static size_t Shrink(ConcreteState::StateGoldenSection& State)
 			{
 				auto& AuxPoints = State.AuxPoints;
 
 				if (AuxPoints[1].Val < AuxPoints[2].Val) {
 					AuxPoints[3] = AuxPoints[2];
 					AuxPoints[2] = AuxPoints[1];
-					AuxPoints[1] = FuncInterface::CreateFromPoint<1>(AuxPoints[0].P + State.resphi * (AuxPoints[3].P - AuxPoints[0].P), f);
+					AuxPoints[1].P = AuxPoints[0].P + State.resphi * (AuxPoints[3].P - AuxPoints[0].P);
+					return 1;
 				}
 				else {
 					AuxPoints[0] = AuxPoints[1];
 					AuxPoints[1] = AuxPoints[2];
-					AuxPoints[2] = FuncInterface::CreateFromPoint<1>(AuxPoints[3].P - State.resphi * (AuxPoints[3].P - AuxPoints[0].P), f);
+					AuxPoints[2].P = AuxPoints[3].P - State.resphi * (AuxPoints[3].P - AuxPoints[0].P);
+					return 2;
 				}
+			}
+
+			/// @brief Takes the value of the new inner point i
+			static PointVal<1> Complete(ConcreteState::StateGoldenSection& State, size_t i, double val)
+			{
+				auto& AuxPoints = State.AuxPoints;
+				AuxPoints[i].Val = val;
 				State.SetDomain({ AuxPoints[0], AuxPoints[3] });
 				return State.Guess();
 			}
@@ -84,6 +125,34 @@ namespace OptLib
 			}
 		};
 	} // StateParams
+
+	namespace ConcreteOptimizer
+	{
+		/// @brief Golden section search as an ask/tell state machine, see OptimizerInterface::AskTell.
+		/// Every step asks for the single new inner point
+		class GoldenSectionAskTell : public OptimizerInterface::AskTell<GoldenSectionAskTell, StateParams::GoldenSectionParams>
+		{
+			using Base = OptimizerInterface::AskTell<GoldenSectionAskTell, StateParams::GoldenSectionParams>;
+			friend Base;
+
+		public:
+			using Base::Base;
+
+		protected:
+			size_t Inner{ 0 };
+
+			void Propose(std::vector<Point<1>>& out)
+			{
+				Inner = GoldenSection::Shrink(*ItsState);
+				out.push_back(ItsState->AuxPoints[Inner].P);
+			}
+
+			void Complete(const double* v)
+			{
+				GoldenSection::Complete(*ItsState, Inner, v[0]);
+			}
+		};
+	} // ConcreteOptimizer
 } // OptLib
 
 #endif
\ No newline at end of file
@@ -1,11 +1,15 @@
 #ifndef GRID_H
 #define GRID_H
 
-#include "../../Points/SetOfPoints/PointVal/Point/Point.h"
-#include "../../Points/SetOfPoints/PointVal/Point/PointOperators.h"
-#include "../../Points/SetOfPoints/PointVal/PointVal.h"
-#include "../../Points/SetOfPoints/PointVal/PointValOperators.h"
+#include <algorithm>
+#include <vector>
+
+#include "../../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../../Points/SetOfPoints/PointVals/Point/PointOperators.h"
+#include "../../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../../Points/SetOfPoints/PointVals/PointValOperators.h"
 #include "../../Points/SetOfPoints/SetOfPoints.h"
+#include "../../Points/SetOfPoints/Selection.h"
 
 #include "../../Functions/Interface/FuncInterface.h"
 
@@ -21,6 +25,7 @@ namespace OptLib
 		class StateGrid : public StateSegment
 		{
 		public:
+			constexpr static const char* CheckpointTag = "Grid";
 			const int n;
 			StateGrid(SetOfPoints<2, OptLib::Point<1>>&& State, FuncInterface::IFunc<1>* f, int n_) : StateSegment(std::move(State), f), n{ n_ }{};
 
@@ -37,14 +42,14 @@ namespace OptLib
 			{
 				int n = State.n;
 				Point<1> step = (State.GuessDomain()[1].P - State.GuessDomain()[0].P) / n;
-				PointVal<1> res{State.GuessDomain()[0]};
-				PointVal<1> currentPoint{res};
-				for(int i = 1; i < n; i++)
-				{
-					currentPoint = FuncInterface::CreateFromPoint<1>(currentPoint.P + step, f);
-					if(currentPoint < res )
-						res = currentPoint;
-				}
+				const PointVal<1>& a{State.GuessDomain()[0]};
+				std::vector<double> vals(static_cast<size_t>(std::max(n, 1)));
+				vals[0] = a.Val;
+				for(int i = 1; i < n; i++) // x_i = a + i * step rather than a running sum, so rounding errors do not accumulate
+					vals[i] = (*f)(a.P + step * static_cast<double>(i));
+
+				size_t best = Selection::ArgMin(vals.data(), vals.size());
+				PointVal<1> res{a.P + step * static_cast<double>(best), vals[best]};
 
 				State.SetGuess(res);
 				return res;
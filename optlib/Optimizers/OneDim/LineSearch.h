@@ -0,0 +1,99 @@
+#ifndef LINESEARCH_H
+#define LINESEARCH_H
+
+#include <type_traits>
+
+#include "../../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../../Points/SetOfPoints/PointVals/PointValOperators.h"
+#include "../../Points/SetOfPoints/SetOfPoints.h"
+#include "../../Points/Definitions.h"
+
+#include "../../Functions/Interface/FuncInterface.h"
+#include "../../Functions/Interface/FunctionWithMemory.h"
+
+#include "../../States/State.h"
+
+namespace OptLib
+{
+	namespace ConcreteOptimizer
+	{
+		/// @brief Bounded minimization of phi(gamma), gamma >= 0, by a method on segments (GoldenSection, Dichotomy, Bisection).
+		/// The 1D function is usually FuncAlongDirection or FuncAlongGradDirection
+		/// @tparam lineParams Parameters of the 1D method. OptAlgo and StateType are taken from there
+		template<typename lineParams>
+		class LineSearch
+		{
+			using algo = typename lineParams::OptAlgo;
+			using state = typename lineParams::StateType;
+
+		public:
+			/// @brief Brackets a minimum starting from the trial step and refines the bracket
+			/// @param phi 1D function to minimize
+			/// @param left Point gamma = 0 evaluated on the previous outer iteration. It is never recalculated
+			/// @param step Trial step
+			/// @param max_iter Maximal number of iterations of the 1D method
+			/// @param tol Tolerance of the 1D method
+			/// @return The best point evaluated during the search. Its Val is never greater than left.Val
+			static PointVal<1> Search(
+				const FuncInterface::IFunc<1>* phi,
+				const PointVal<1>& left,
+				double step,
+				size_t max_iter,
+				double tol)
+			{
+				FunctWithCounter::IBestFunc<1> f{ phi };
+				f.Seed(left);
+
+				state State{ MakeState(Bracket(&f, left, step), &f) };
+				for (size_t i = 0; i < max_iter && !State.IsConverged(tol, tol); ++i)
+					algo::Proceed(State, &f);
+
+				return f.Best();
+			}
+
+		protected:
+			static constexpr size_t MaxExpansions = 32;
+
+			/// @brief Expands or shrinks [0, step] until it holds a point below phi(0).
+			/// Evaluated end points are reused by the 1D method
+			static SimplexVal<1> Bracket(
+				const FuncInterface::IFunc<1>* f,
+				const PointVal<1>& left,
+				double step)
+			{
+				PointVal<1> lo{ left };
+				PointVal<1> mid{ FuncInterface::CreateFromPoint<1>(Point<1>{ lo.P[0] + step }, f) };
+				if (!(mid < lo))
+				{ // the trial step is too long, phi may be multimodal on [0, step]
+					PointVal<1> hi{ mid };
+					for (size_t i = 0; !(mid < lo) && i < MaxExpansions; ++i)
+					{
+						hi = mid;
+						mid = FuncInterface::CreateFromPoint<1>(Point<1>{ (lo.P[0] + hi.P[0]) / 2.0 }, f);
+					}
+					return SimplexVal<1>{ lo, hi };
+				}
+
+				PointVal<1> hi{ FuncInterface::CreateFromPoint<1>(Point<1>{ lo.P[0] + 2.0 * step }, f) };
+				for (size_t i = 0; hi < mid && i < MaxExpansions; ++i)
+				{
+					lo = mid;
+					mid = hi;
+					hi = FuncInterface::CreateFromPoint<1>(Point<1>{ 2.0 * hi.P[0] - left.P[0] }, f);
+				}
+				return SimplexVal<1>{ lo, hi };
+			}
+
+			static state MakeState(SimplexVal<1>&& segment, FuncInterface::IFunc<1>* f)
+			{
+				if constexpr (std::is_constructible_v<state, SimplexVal<1>&&>) // the state has no auxiliary points
+					return state{ std::move(segment) };
+				else
+					return state{ std::move(segment), f };
+			}
+		};
+	} // ConcreteOptimizer
+} // OptLib
+
+#endif
@@ -0,0 +1,373 @@
+#ifndef SEGMENTLANES_H
+#define SEGMENTLANES_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+#include "../../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../../Points/SetOfPoints/SetOfPoints.h"
+
+#include "../../Functions/Interface/FuncInterface.h"
+
+namespace OptLib
+{
+	namespace ConcreteState
+	{
+		/// @brief lanes independent segments [A[i], B[i]] stored as structure of arrays.
+		/// A lane is frozen once its segment is shorter than the tolerance, the others proceed.
+		/// Frozen lanes are still evaluated, so that every batch call has the same shape
+		template<size_t lanes>
+		class StateSegmentLanes
+		{
+		public:
+			constexpr static const char* CheckpointTag = "SegmentLanes";
+			using CheckpointParts = std::tuple<std::integral_constant<size_t, lanes>>;
+			using func_type = FuncInterface::IFuncLanes<lanes>;
+			using lanes_type = FuncInterface::Lanes<lanes>;
+			// 64-bit flags rather than bool, so that the masked loops vectorize together with the doubles
+			using mask_type = std::array<std::int64_t, lanes>;
+
+			lanes_type A, B; // ends of the segments, A[i] < B[i]
+			lanes_type FA, FB;
+			mask_type Active;
+
+			// tolerance of the lanes, which freezes them
+			const double AbsTol;
+			const double RelTol;
+
+			StateSegmentLanes(const lanes_type& a, const lanes_type& b, const func_type* f, double absTol, double relTol) :
+				AbsTol{ absTol },
+				RelTol{ relTol }
+			{
+				for (size_t i = 0; i < lanes; ++i)
+				{
+					A[i] = std::min(a[i], b[i]);
+					B[i] = std::max(a[i], b[i]);
+				}
+				(*f)(A, FA);
+				(*f)(B, FB);
+				Active.fill(1);
+				UpdateMask();
+			}
+
+			/// @brief All the lanes are frozen or meet the tolerances
+			bool IsConverged(double abs_tol, double rel_tol) const
+			{
+				std::int64_t running = 0;
+#pragma omp simd reduction(|:running)
+				for (size_t i = 0; i < lanes; ++i)
+					running |= Active[i] & (LaneConverged(i, abs_tol, rel_tol) ? 0 : 1);
+				return running == 0;
+			}
+
+			size_t ActiveCount() const
+			{
+				return static_cast<size_t>(std::count(Active.begin(), Active.end(), 1));
+			}
+
+			/// @brief Guess of the i-th lane, the middle of its segment
+			virtual PointVal<1> Guess(size_t i) const
+			{
+				return PointVal<1>{ Point<1>{ (A[i] + B[i]) / 2.0 }, (FA[i] + FB[i]) / 2.0 };
+			}
+
+			void UpdateMask()
+			{
+#pragma omp simd
+				for (size_t i = 0; i < lanes; ++i)
+					Active[i] &= LaneConverged(i, AbsTol, RelTol) ? 0 : 1;
+			}
+
+			/// @brief Reads or writes the segments and the mask, see Checkpoint.h
+			template<typename archive>
+			void Serialize(archive& ar) { ar(A, B, FA, FB, Active); }
+
+		protected:
+			bool LaneConverged(size_t i, double abs_tol, double rel_tol) const
+			{
+				double half = (B[i] - A[i]) / 2.0;
+				return half < abs_tol || half < rel_tol * std::abs(A[i] + half);
+			}
+		};
+
+		template<size_t lanes>
+		using StateDichotomyLanes = StateSegmentLanes<lanes>;
+
+		/// @brief Inner points X1 < X2 of the golden section in every lane
+		template<size_t lanes>
+		class StateGoldenSectionLanes : public StateSegmentLanes<lanes>
+		{
+			using Base = StateSegmentLanes<lanes>;
+		public:
+			constexpr static const char* CheckpointTag = "GoldenSectionLanes";
+			using typename Base::lanes_type;
+			using typename Base::func_type;
+
+			lanes_type X1, X2, F1, F2;
+			const double resphi{ (3.0 - std::sqrt(5.0)) / 2.0 };
+
+			StateGoldenSectionLanes(const lanes_type& a, const lanes_type& b, const func_type* f, double absTol, double relTol) :
+				Base{ a, b, f, absTol, relTol }
+			{
+				for (size_t i = 0; i < lanes; ++i)
+				{
+					X1[i] = this->A[i] + resphi * (this->B[i] - this->A[i]);
+					X2[i] = this->B[i] - resphi * (this->B[i] - this->A[i]);
+				}
+				(*f)(X1, F1);
+				(*f)(X2, F2);
+			}
+
+			/// @brief The best inner point rather than the middle of the segment
+			PointVal<1> Guess(size_t i) const override
+			{
+				return F1[i] < F2[i] ? PointVal<1>{ Point<1>{ X1[i] }, F1[i] } : PointVal<1>{ Point<1>{ X2[i] }, F2[i] };
+			}
+
+			template<typename archive>
+			void Serialize(archive& ar)
+			{
+				Base::Serialize(ar);
+				ar(X1, X2, F1, F2);
+			}
+		};
+
+		/// @brief Five equidistant points X[0] = A, ..., X[4] = B in every lane
+		template<size_t lanes>
+		class StateBisectionLanes : public StateSegmentLanes<lanes>
+		{
+			using Base = StateSegmentLanes<lanes>;
+		public:
+			constexpr static const char* CheckpointTag = "BisectionLanes";
+			using typename Base::lanes_type;
+			using typename Base::func_type;
+
+			std::array<lanes_type, 5> X, F;
+
+			StateBisectionLanes(const lanes_type& a, const lanes_type& b, const func_type* f, double absTol, double relTol) :
+				Base{ a, b, f, absTol, relTol }
+			{
+				X[0] = this->A; F[0] = this->FA;
+				X[4] = this->B; F[4] = this->FB;
+				for (size_t k = 1; k < 4; ++k)
+				{
+					for (size_t i = 0; i < lanes; ++i)
+						X[k][i] = this->A[i] + static_cast<double>(k) * (this->B[i] - this->A[i]) / 4.0;
+					(*f)(X[k], F[k]);
+				}
+			}
+
+			/// @brief The best of the five points
+			PointVal<1> Guess(size_t i) const override
+			{
+				size_t best = 0;
+				for (size_t k = 1; k < 5; ++k)
+					if (F[k][i] < F[best][i]) best = k;
+				return PointVal<1>{ Point<1>{ X[best][i] }, F[best][i] };
+			}
+
+			template<typename archive>
+			void Serialize(archive& ar)
+			{
+				Base::Serialize(ar);
+				ar(X, F);
+			}
+		};
+	} // ConcreteState
+
+	namespace ConcreteOptimizer
+	{
+		/// @brief GoldenSection advancing all the lanes at once: one batch evaluation per iteration.
+		/// The branch of every lane is turned into a select, so the loops vectorize
+		template<size_t lanes>
+		class GoldenSectionLanes
+		{
+		public:
+			static void Proceed(ConcreteState::StateGoldenSectionLanes<lanes>& State, const FuncInterface::IFuncLanes<lanes>* f)
+			{
+				auto& S = State;
+				FuncInterface::Lanes<lanes> xn, fn;
+				typename ConcreteState::StateGoldenSectionLanes<lanes>::mask_type left; // the minimum is in [A, X2]
+
+#pragma omp simd
+				for (size_t i = 0; i < lanes; ++i)
+				{
+					left[i] = S.F1[i] < S.F2[i] ? 1 : 0;
+					double a = left[i] ? S.A[i] : S.X1[i];
+					double b = left[i] ? S.X2[i] : S.B[i];
+					xn[i] = left[i] ? a + S.resphi * (b - a) : b - S.resphi * (b - a);
+				}
+
+				(*f)(xn, fn);
+
+#pragma omp simd
+				for (size_t i = 0; i < lanes; ++i)
+				{
+					bool on = S.Active[i] != 0;
+					bool l = left[i] != 0;
+					double x1 = S.X1[i], x2 = S.X2[i], f1 = S.F1[i], f2 = S.F2[i];
+					// the left move: B = X2, X2 = X1, X1 = xn; the right move: A = X1, X1 = X2, X2 = xn
+					S.B[i] = on && l ? x2 : S.B[i];
+					S.FB[i] = on && l ? f2 : S.FB[i];
+					S.A[i] = on && !l ? x1 : S.A[i];
+					S.FA[i] = on && !l ? f1 : S.FA[i];
+					S.X1[i] = on ? (l ? xn[i] : x2) : x1;
+					S.F1[i] = on ? (l ? fn[i] : f2) : f1;
+					S.X2[i] = on ? (l ? x1 : xn[i]) : x2;
+					S.F2[i] = on ? (l ? f1 : fn[i]) : f2;
+				}
+				State.UpdateMask();
+			}
+		};
+
+		/// @brief Dichotomy advancing all the lanes at once: two batch evaluations per iteration
+		template<size_t lanes>
+		class DichotomyLanes
+		{
+		public:
+			static void Proceed(ConcreteState::StateDichotomyLanes<lanes>& State, const FuncInterface::IFuncLanes<lanes>* f)
+			{
+				auto& S = State;
+				FuncInterface::Lanes<lanes> x1, x2, f1, f2;
+
+#pragma omp simd
+				for (size_t i = 0; i < lanes; ++i)
+				{
+					double c = (S.A[i] + S.B[i]) / 2.0;
+					double e = (S.B[i] - S.A[i]) / 4.0;
+					x1[i] = c - e;
+					x2[i] = c + e;
+				}
+
+				(*f)(x1, f1);
+				(*f)(x2, f2);
+
+#pragma omp simd
+				for (size_t i = 0; i < lanes; ++i)
+				{
+					bool on = S.Active[i] != 0;
+					bool l = f1[i] < f2[i];
+					S.B[i] = on && l ? x2[i] : S.B[i];
+					S.FB[i] = on && l ? f2[i] : S.FB[i];
+					S.A[i] = on && !l ? x1[i] : S.A[i];
+					S.FA[i] = on && !l ? f1[i] : S.FA[i];
+				}
+				State.UpdateMask();
+			}
+		};
+
+		/// @brief Bisection advancing all the lanes at once.
+		/// The segment shrinks to the neighbours of the best of the five points. The quarter points
+		/// are evaluated in two batches, the middle point needs a third batch only if the best point of an active lane is an end
+		template<size_t lanes>
+		class BisectionLanes
+		{
+		public:
+			static void Proceed(ConcreteState::StateBisectionLanes<lanes>& State, const FuncInterface::IFuncLanes<lanes>* f)
+			{
+				auto& S = State;
+				auto& X = S.X;
+				auto& F = S.F;
+
+				std::array<size_t, lanes> pos;
+				bool needMiddle = false;
+				for (size_t i = 0; i < lanes; ++i)
+				{
+					size_t best = 0;
+					for (size_t k = 1; k < 5; ++k)
+						best = F[k][i] < F[best][i] ? k : best;
+					pos[i] = best;
+					needMiddle = needMiddle || (S.Active[i] && (best == 0 || best == 4));
+				}
+
+				// new ends and the middle, the middle is known unless the best point is an end
+				FuncInterface::Lanes<lanes> a, b, fa, fb, m, fm;
+				for (size_t i = 0; i < lanes; ++i)
+				{
+					size_t lo = pos[i] == 0 ? 0 : (pos[i] == 4 ? 3 : pos[i] - 1);
+					size_t hi = lo + (pos[i] == 0 || pos[i] == 4 ? 1 : 2);
+					a[i] = X[lo][i]; fa[i] = F[lo][i];
+					b[i] = X[hi][i]; fb[i] = F[hi][i];
+					m[i] = hi - lo == 2 ? X[pos[i]][i] : (a[i] + b[i]) / 2.0;
+					fm[i] = F[pos[i]][i];
+				}
+				if (needMiddle)
+				{
+					FuncInterface::Lanes<lanes> fmid;
+					(*f)(m, fmid);
+					for (size_t i = 0; i < lanes; ++i)
+						fm[i] = pos[i] == 0 || pos[i] == 4 ? fmid[i] : fm[i];
+				}
+
+				FuncInterface::Lanes<lanes> q1, q3, f1, f3;
+#pragma omp simd
+				for (size_t i = 0; i < lanes; ++i)
+				{
+					q1[i] = (a[i] + m[i]) / 2.0;
+					q3[i] = (m[i] + b[i]) / 2.0;
+				}
+				(*f)(q1, f1);
+				(*f)(q3, f3);
+
+#pragma omp simd
+				for (size_t i = 0; i < lanes; ++i)
+				{
+					bool on = S.Active[i] != 0;
+					X[0][i] = on ? a[i] : X[0][i];  F[0][i] = on ? fa[i] : F[0][i];
+					X[1][i] = on ? q1[i] : X[1][i]; F[1][i] = on ? f1[i] : F[1][i];
+					X[2][i] = on ? m[i] : X[2][i];  F[2][i] = on ? fm[i] : F[2][i];
+					X[3][i] = on ? q3[i] : X[3][i]; F[3][i] = on ? f3[i] : F[3][i];
+					X[4][i] = on ? b[i] : X[4][i];  F[4][i] = on ? fb[i] : F[4][i];
+					S.A[i] = X[0][i]; S.FA[i] = F[0][i];
+					S.B[i] = X[4][i]; S.FB[i] = F[4][i];
+				}
+				State.UpdateMask();
+			}
+		};
+	} // ConcreteOptimizer
+
+	namespace StateParams
+	{
+		template<size_t lanes, typename algo, typename state>
+		struct SegmentLanesParams
+		{
+		public:
+			using OptAlgo = algo;
+			using StateType = state;
+
+		public:
+			FuncInterface::Lanes<lanes> Left;
+			FuncInterface::Lanes<lanes> Right;
+			SegmentLanesParams(const FuncInterface::Lanes<lanes>& a, const FuncInterface::Lanes<lanes>& b, double absTol = 1.0E-10, double relTol = 1.0E-10)
+				:Left{ a }, Right{ b }, absTol{ absTol }, relTol{ relTol }
+			{}
+			StateType CreateState(FuncInterface::IFuncLanes<lanes>* f)
+			{
+				return { Left, Right, f, absTol, relTol };
+			}
+
+		protected:
+			double absTol;
+			double relTol;
+		};
+
+		template<size_t lanes>
+		using GoldenSectionLanesParams = SegmentLanesParams<lanes,
+			ConcreteOptimizer::GoldenSectionLanes<lanes>, ConcreteState::StateGoldenSectionLanes<lanes>>;
+
+		template<size_t lanes>
+		using DichotomyLanesParams = SegmentLanesParams<lanes,
+			ConcreteOptimizer::DichotomyLanes<lanes>, ConcreteState::StateDichotomyLanes<lanes>>;
+
+		template<size_t lanes>
+		using BisectionLanesParams = SegmentLanesParams<lanes,
+			ConcreteOptimizer::BisectionLanes<lanes>, ConcreteState::StateBisectionLanes<lanes>>;
+	} // StateParams
+} // OptLib
+
+#endif
@@ -1,19 +1,102 @@
 #pragma once
 
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 #include "OptimizerInterface.h"
+#include "AsyncOptimization.h"
+#include "Observers.h"
+#include "../Functions/Interface/FunctionWithMemory.h"
 
 namespace OptLib
 {
+	/// @brief Stopping criteria of Optimizer. The first three are required, the rest are disabled by default,
+	/// e.g., OptimizerParams{ .eps_f = 1E-9, .eps_x = 1E-9, .max_iter = 1000, .deadline = std::chrono::steady_clock::now() + 50ms }.
+	/// The run has converged when both tolerances are met after an iteration
 	struct OptimizerParams
 	{
-		double eps_f, eps_x;
+		// bounds the change of the value of the guess over the last eps_f_window iterations, absolute or relative to the value
+		double eps_f;
+		// passed to IState::IsConverged as both its absolute and relative tolerance, e.g., on the spread
+		// of the points and of the values of a simplex, or on the step of a point state
+		double eps_x;
 		size_t max_iter;
+		// no iteration is started after it, the monotonic clock is read once per iteration
+		std::chrono::steady_clock::time_point deadline{ std::chrono::steady_clock::time_point::max() };
+		// no iteration is started after f is called so many times, f must be a FunctWithCounter::ICounterFunc, otherwise
+		// the run throws std::logic_error
+		size_t max_evals{ std::numeric_limits<size_t>::max() };
+		// stops if the value of the guess decreases by no more than stall_tol over stall_iter iterations, 0 disables
+		size_t stall_iter{ 0 };
+		double stall_tol{ 0.0 };
+		// stops as soon as the value of the guess is at most target
+		double target{ -std::numeric_limits<double>::infinity() };
+		// iterations eps_f is measured over, 0 selects dim + 1. The states that report the best point so far,
+		// e.g., the populations, keep the same guess for several iterations while they still make progress
+		size_t eps_f_window{ 0 };
+
+		/// @brief The criterion of eps_f for the values of the guess at the beginning and at the end of the window
+		bool ValueConverged(double before, double after) const
+		{
+			const double d = std::abs(after - before);
+			return d < eps_f || d < eps_f * std::abs(after);
+		}
 	};
 
-	template<typename state>
+	/// @brief The values of the guess over the last eps_f_window iterations of a run, see OptimizerParams::ValueConverged
+	class ValueWindow
+	{
+	public:
+		/// @param v0 The value of the guess before the first iteration
+		ValueWindow(const OptimizerParams& prm, size_t dim, double v0) :
+			Prm{ prm },
+			Values(prm.eps_f_window > 0 ? prm.eps_f_window : dim + 1, v0)
+		{}
+
+		/// @brief Adds the value after an iteration
+		/// @return Whether the value has changed by less than eps_f over the window. Never before the window is filled
+		bool Converged(double v)
+		{
+			double& before = Values[Count % Values.size()]; // the value Values.size() iterations ago
+			const bool full = ++Count >= Values.size();
+			const bool out = full && Prm.ValueConverged(before, v);
+			before = v;
+			return out;
+		}
+
+	protected:
+		const OptimizerParams& Prm;
+		std::vector<double> Values;
+		size_t Count{ 0 };
+	};
+
+	/// @brief Why Optimizer stopped
+	enum class StopReason
+	{
+		None, // has not run yet
+		Converged,
+		MaxIterations,
+		Deadline,
+		MaxEvaluations,
+		Stagnation,
+		Target,
+		Cancelled
+	};
+
+	/// @tparam observer Hooks called by the loop, see Observers.h. Observers::None costs nothing
+	template<typename state, typename observer = Observers::None>
 	class Optimizer
 	{
 	public:
+		constexpr static const char* CheckpointTag = "Optimizer";
+		using CheckpointParts = std::tuple<state>;
 		constexpr static size_t arg_count = state::arg_count;
 		
 		using func = typename state::func_type;
@@ -22,44 +105,73 @@ namespace OptLib
 		double tol_x() { return Prm.eps_x; }
 		size_t MaxIterCount() { return Prm.max_iter; }
 		size_t CurIterCount() { return s; }
+		StopReason Reason() const { return ItsReason; }
 		const PointVal<arg_count>& CurrentGuess() { return State->Guess(); }
+		/// @brief Calls of f if it is a FunctWithCounter::ICounterFunc, otherwise 0
+		size_t Evaluations() const
+		{
+			return Counted ? Counted->Counter.load(std::memory_order_relaxed) : 0;
+		}
+		observer& Observer() { return ItsObserver; }
+		const observer& Observer() const { return ItsObserver; }
 
 	public:
-		Optimizer(state* State_, func* f_, const OptimizerParams& prm) :
+		Optimizer(state* State_, func* f_, const OptimizerParams& prm, observer obs = observer{}) :
 			State{State_},
 			f{f_},
+			Counted{ dynamic_cast<const FunctWithCounter::ICounterFunc<arg_count>*>(f_) },
+			s{ 0 },
 			Prm{ prm },
-			s{ 0 }
+			ItsObserver{ std::move(obs) }
 			{}
 
+		/// @brief Iterates until one of the criteria of OptimizerParams is met, see Reason()
 		template<typename algo>
 		const PointVal<arg_count>& Optimize()
 		{
-#ifdef DEBUG_LIB
-			std::cout << "Optimization started...\n";
-#endif // DEBUG_LIB
-
-			// TODO : separate thread
-			bool g = false;
-			while (!g &&
-				s < MaxIterCount())
-			{
-#ifdef DEBUG_LIB
-				std::cout << "Current state: " << State->Guess() << "\n";
-#endif // DEBUG_LIB
-				OptimizerInterface::OptimizerAlgorithm<arg_count, algo, state, func>::Proceed(State, f);
-				++s;
-				g = OptimizerInterface::OptimizerAlgorithm<arg_count, algo, state, func>::IsConverged(State, tol_x(), tol_x());
-			}
-#ifdef DEBUG_LIB
-			std::cout << "Optimization ended\n";
-			std::cout << "Total number of iterations is s = " << CurIterCount() << '\n';
-			std::cout << "Final guess is x = " << CurrentGuess() << '\n';
-#endif // DEBUG_LIB
-
+			ItsReason = Loop<algo>([]() { return false; }, []() {});
 			return CurrentGuess();
 		}
 
+		/// @brief Runs the loop of Optimize on the executor and returns at once. The progress is published after
+		/// every iteration and can be read from any thread through the handle. The loop also stops if the handle
+		/// is cancelled, with StopReason::Cancelled. Neither the optimizer, nor the state, nor f may be used by the caller until the handle is ready
+		/// @param Execute Callable that runs a job once on some thread, a new thread by default
+		template<typename algo, typename executor = ThreadExecutor>
+		AsyncOptimization<arg_count> OptimizeAsync(executor&& Execute = executor{})
+		{
+			using shared = typename AsyncOptimization<arg_count>::Shared;
+			auto Shared{ std::make_shared<shared>() };
+			Shared->Board.Publish(CurrentGuess(), s, Evaluations());
+
+			Execute([this, Shared]()
+				{
+					try
+					{
+						std::stop_token stop{ Shared->Stop.get_token() };
+						ItsReason = Loop<algo>(
+							[&stop]() { return stop.stop_requested(); },
+							[this, &Shared]() { Shared->Board.Publish(CurrentGuess(), s, Evaluations()); });
+						Shared->Done.set_value(CurrentGuess());
+					}
+					catch (...)
+					{
+						Shared->Done.set_exception(std::current_exception());
+					}
+				});
+			// the future is taken after the job is handed over: if the executor throws, nobody waits for it
+			return AsyncOptimization<arg_count>{ Shared };
+		}
+
+		/// @brief Reads or writes the iteration counter and the state, see Checkpoint.h. The criteria are not stored,
+		/// so a resumed run may get a new budget
+		template<typename archive>
+		void Serialize(archive& ar)
+		{
+			ar(s, ItsReason);
+			State->Serialize(ar);
+		}
+
 		template<typename algo>
 		PointVal<arg_count> Continue(double eps_x, double eps_f)
 		{
@@ -71,14 +183,101 @@ namespace OptLib
 	protected:
 		state* State;
 		func* f;
+		const FunctWithCounter::ICounterFunc<arg_count>* Counted; // f if it counts its calls, otherwise nullptr
 
 		size_t s; // current number of iterations
 		OptimizerParams Prm;
+		StopReason ItsReason{ StopReason::None };
+		[[no_unique_address]] observer ItsObserver;
+
+		/// @brief One iteration
+		/// @return Whether the state has converged, see OptimizerParams
+		template<typename algo>
+		bool Step(ValueWindow& Window)
+		{
+			OptimizerInterface::OptimizerAlgorithm<arg_count, algo, state, func>::Proceed(State, f);
+			++s;
+			const bool values = Window.Converged(CurrentGuess().Val);
+			return OptimizerInterface::OptimizerAlgorithm<arg_count, algo, state, func>::IsConverged(State, tol_x(), tol_x()) && values;
+		}
+
+		/// @brief The loop of Optimize. The budgets are checked before an iteration, so none is started after
+		/// a budget is spent, the guess is checked after it
+		/// @param Cancelled Returns true to stop before the next iteration
+		/// @param Publish Called after every iteration and its hooks
+		template<typename algo, typename cancelled, typename publish>
+		StopReason Loop(cancelled&& Cancelled, publish&& Publish)
+		{
+			using clock = std::chrono::steady_clock;
+			const bool timed = Prm.deadline != clock::time_point::max();
+			const bool counted = Prm.max_evals != std::numeric_limits<size_t>::max();
+			if (counted && !Counted)
+				throw std::logic_error{ "Optimizer: max_evals needs f to be a FunctWithCounter::ICounterFunc" };
+
+			auto stop = [this](StopReason r)
+			{
+				if constexpr (requires { ItsObserver.Stopped(s, *State); })
+					ItsObserver.Stopped(s, *State);
+				return r;
+			};
+
+			constexpr bool evaluated = requires { ItsObserver.Evaluated(s, s); };
+			if constexpr (evaluated)
+				ItsObserver.Evaluated(0, Evaluations()); // the calls before the run, e.g., of the creation of the state
+			if constexpr (requires { ItsObserver.Started(s, *State); })
+				ItsObserver.Started(s, *State);
+
+			ValueWindow Window{ Prm, arg_count, CurrentGuess().Val };
+			size_t windowStart = s;
+			double windowVal = CurrentGuess().Val;
+			for (;;)
+			{
+				if (s >= MaxIterCount()) return stop(StopReason::MaxIterations);
+				if (Cancelled()) return stop(StopReason::Cancelled);
+				if (timed && clock::now() >= Prm.deadline) return stop(StopReason::Deadline);
+				if (counted && Evaluations() >= Prm.max_evals) return stop(StopReason::MaxEvaluations);
+
+				const size_t it = s + 1;
+				if constexpr (requires { ItsObserver.IterationStarted(it); })
+					ItsObserver.IterationStarted(it);
+				size_t before = 0;
+				if constexpr (evaluated)
+					before = Evaluations();
+
+				bool g = Step<algo>(Window);
+
+				if constexpr (evaluated)
+				{
+					const size_t total = Evaluations();
+					ItsObserver.Evaluated(total - before, total);
+				}
+				if constexpr (requires { ItsObserver.Updated(it, *State); })
+					ItsObserver.Updated(it, *State);
+				if constexpr (requires { ItsObserver.IterationEnded(it); })
+					ItsObserver.IterationEnded(it);
+				Publish();
+
+				if (g)
+				{
+					if constexpr (requires { ItsObserver.Converged(it, *State); })
+						ItsObserver.Converged(it, *State);
+					return stop(StopReason::Converged);
+				}
+				const double v = CurrentGuess().Val;
+				if (v <= Prm.target) return stop(StopReason::Target);
+				if (Prm.stall_iter > 0 && s - windowStart >= Prm.stall_iter)
+				{
+					if (!(windowVal - v > Prm.stall_tol)) return stop(StopReason::Stagnation);
+					windowStart = s;
+					windowVal = v;
+				}
+			}
+		}
 	};
 
 	template<size_t dim,
 		typename state,
-		template<size_t dim> typename func>
+		template<size_t> typename func>
 	class Optimizer1Step
 	{
 	protected:
@@ -93,7 +292,7 @@ namespace OptLib
 		template<typename algo>
 		PointVal<dim> Optimize()
 		{
-			OptimizerInterface::OptimizerAlgorithm<dim>::Proceed(State, f);
+			OptimizerInterface::OptimizerAlgorithm<dim, algo, state, func<dim>>::Proceed(State, f);
 			return CurrentGuess();
 		}
 	};
@@ -3,6 +3,7 @@
 
 #include "SetOfPoints/PointVals/Point/Point.h"
 #include "SetOfPoints/SetOfPoints.h"
+#include "SetOfPoints/Selection.h"
 
 namespace OptLib
 {
@@ -72,7 +73,7 @@ namespace OptLib
         using Base::begin;
         using Base::end;
         
-        void Sort() { std::sort(begin(), end()); }
+        void Sort() { Selection::SortByVal(*this); } // a sorting network for simplexes with up to 32 points
 
     public:
         SetOfPointValsSort() = default;
@@ -90,6 +91,27 @@ namespace OptLib
                                                          SetOfPointValsSort<count, pointval>{make_field(std::forward<T>(s), funcVals)}
         {
         }
+
+        /// <summary>
+        /// Replaces the i-th point and keeps the set sorted. 
+        /// The new position is found by binary search, only the points in between are shifted
+        /// </summary>
+        void Replace(size_t i, pointval &&v)
+        {
+            auto it{begin() + i};
+            if (v < *it)
+            { // moves towards the best point
+                auto pos{std::upper_bound(begin(), it, v)};
+                std::move_backward(pos, it, it + 1);
+                *pos = std::move(v);
+            }
+            else
+            {
+                auto pos{std::lower_bound(it + 1, end(), v)};
+                std::move(it + 1, pos, it);
+                *(pos - 1) = std::move(v);
+            }
+        }
     };
 }
 
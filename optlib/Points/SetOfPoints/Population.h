@@ -0,0 +1,88 @@
+#ifndef POPULATION_H
+#define POPULATION_H
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "PointVals/Point/Point.h"
+
+namespace OptLib
+{
+    /// @brief Population of a run-time size stored as a Size x dim column-major matrix with
+    /// the individuals as rows: the i-th coordinates of all the individuals are contiguous.
+    /// The loops of the population methods run over the individuals of one axis and vectorize.
+    /// Unlike SetOfPoints, the size is not a compile-time constant, as populations reach 10^4 individuals
+    template <size_t dim>
+    class Population
+    {
+    public:
+        Population() = default;
+
+        explicit Population(size_t size) : ItsSize{size}, Data(dim * size) {}
+
+        size_t Size() const { return ItsSize; }
+
+        /// @brief The i-th coordinates of all the individuals
+        double *Axis(size_t i) { return Data.data() + i * ItsSize; }
+        const double *Axis(size_t i) const { return Data.data() + i * ItsSize; }
+
+        double &operator()(size_t i, size_t k) { return Data[i * ItsSize + k]; }
+        double operator()(size_t i, size_t k) const { return Data[i * ItsSize + k]; }
+
+        Point<dim> Get(size_t k) const
+        {
+            Point<dim> p;
+            for (size_t i = 0; i < dim; ++i)
+                p[i] = (*this)(i, k);
+            return p;
+        }
+
+        void Set(size_t k, const Point<dim> &p)
+        {
+            for (size_t i = 0; i < dim; ++i)
+                (*this)(i, k) = p[i];
+        }
+
+        /// @brief Copies the individuals to points, e.g., to evaluate them as one batch
+        void Gather(std::vector<Point<dim>> &out) const
+        {
+            out.resize(ItsSize);
+            for (size_t k = 0; k < ItsSize; ++k) // the points are written contiguously, the axes are read as dim streams
+                for (size_t i = 0; i < dim; ++i)
+                    out[k][i] = Data[i * ItsSize + k];
+        }
+
+        /// @brief Mean and standard deviation of every coordinate over the population
+        std::pair<Point<dim>, Point<dim>> Dispersion() const
+        {
+            Point<dim> avg, sd;
+            const double n = static_cast<double>(ItsSize);
+            for (size_t i = 0; i < dim; ++i)
+            {
+                const double *a = Axis(i);
+                double s = 0.0;
+#pragma omp simd reduction(+ : s)
+                for (size_t k = 0; k < ItsSize; ++k)
+                    s += a[k];
+                const double m = s / n;
+                double q = 0.0;
+#pragma omp simd reduction(+ : q)
+                for (size_t k = 0; k < ItsSize; ++k)
+                    q += (a[k] - m) * (a[k] - m);
+                avg[i] = m;
+                sd[i] = std::sqrt(q / n);
+            }
+            return {avg, sd};
+        }
+
+        template <typename archive>
+        void Serialize(archive &ar) { ar(ItsSize, Data); }
+
+    protected:
+        size_t ItsSize{0};
+        std::vector<double> Data;
+    };
+} // OptLib
+
+#endif
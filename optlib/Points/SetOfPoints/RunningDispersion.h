@@ -0,0 +1,72 @@
+#ifndef RUNNINGDISPERSION_H
+#define RUNNINGDISPERSION_H
+
+#include <tuple>
+
+#include "SetOfPoints.h"
+
+namespace OptLib
+{
+    /// <summary>
+    /// Mean and dispersion of a set of points, which are updated in O(1) point operations 
+    /// when a single point of the set is replaced. 
+    /// Sums are taken around a shift close to the mean to reduce cancellation, 
+    /// Reset recalculates them exactly and re-centers the shift.
+    /// </summary>
+    template <size_t count, typename point>
+    class RunningDispersion
+    {
+    public:
+        RunningDispersion() = default;
+        RunningDispersion(const SetOfPoints<count, point> &s)
+        {
+            Reset(s);
+        }
+
+        void Reset(const SetOfPoints<count, point> &s)
+        { // requires vector+-*vector, vector/double
+            static_assert(count > 0);
+            shift = s.mean();
+            sum = s[0] - shift;
+            sumsq = sum * sum;
+            for (size_t i = 1; i < count; ++i)
+            {
+                point d{s[i] - shift};
+                sum = sum + d;
+                sumsq = sumsq + d * d;
+            }
+        }
+
+        /// @brief Accounts for the substitution of p_old by p_new in the set
+        void Replace(const point &p_old, const point &p_new)
+        {
+            point d_old{p_old - shift};
+            point d_new{p_new - shift};
+            sum = sum + (d_new - d_old);
+            sumsq = sumsq + (d_new * d_new - d_old * d_old);
+        }
+
+        point mean() const
+        {
+            return shift + sum / (double)count;
+        }
+
+        /// @brief The same as SetOfPoints::dispersion
+        auto dispersion() const
+        { // requires abs(vector), round-off may make the difference slightly negative
+            point m{sum / (double)count};
+            return std::pair<point, point>{shift + m, abs(sumsq / (double)count - m * m)};
+        }
+
+        /// @brief The sums rather than a recalculation, so the drift of a restored state is the same, see Checkpoint.h
+        template <typename archive>
+        void Serialize(archive &ar) { ar(shift, sum, sumsq); }
+
+    protected:
+        point shift{};
+        point sum{};
+        point sumsq{};
+    };
+} // OptLib
+
+#endif
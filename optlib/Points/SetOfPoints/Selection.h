@@ -0,0 +1,233 @@
+#ifndef SELECTION_H
+#define SELECTION_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include "SetOfPoints.h"
+
+namespace OptLib
+{
+    /// @brief Branch-free selection over the value column of sets of PointVal and of plain arrays of values.
+    /// Ties are resolved in favour of the smaller index, so the results do not depend on the vector width
+    namespace Selection
+    {
+        // number of independent minima kept by the kernels, enough for 8 doubles of AVX-512
+        constexpr size_t SimdWidth = 8;
+
+        /// @brief Index of the smallest value, NaN values are skipped. 0 if all the values are NaN. n > 0
+        inline size_t ArgMin(const double *v, size_t n)
+        {
+            assert(n > 0);
+            std::array<double, SimdWidth> best;
+            std::array<std::uint64_t, SimdWidth> idx;
+            best.fill(std::numeric_limits<double>::infinity());
+            idx.fill(n);
+
+            size_t i = 0;
+            for (; i + SimdWidth <= n; i += SimdWidth)
+            {
+#pragma omp simd
+                for (size_t j = 0; j < SimdWidth; ++j)
+                {
+                    bool lt = v[i + j] < best[j];
+                    best[j] = lt ? v[i + j] : best[j];
+                    idx[j] = lt ? i + j : idx[j];
+                }
+            }
+            for (size_t j = 0; i < n; ++i, ++j)
+                if (v[i] < best[j])
+                {
+                    best[j] = v[i];
+                    idx[j] = i;
+                }
+
+            size_t out = 0;
+            for (size_t j = 1; j < SimdWidth; ++j)
+                if (best[j] < best[out] || (best[j] == best[out] && idx[j] < idx[out]))
+                    out = j;
+            return idx[out] < n ? idx[out] : 0;
+        }
+
+        /// @brief Index of the largest value, NaN values are skipped. 0 if all the values are NaN. n > 0
+        inline size_t ArgMax(const double *v, size_t n)
+        {
+            assert(n > 0);
+            std::array<double, SimdWidth> best;
+            std::array<std::uint64_t, SimdWidth> idx;
+            best.fill(-std::numeric_limits<double>::infinity());
+            idx.fill(n);
+
+            size_t i = 0;
+            for (; i + SimdWidth <= n; i += SimdWidth)
+            {
+#pragma omp simd
+                for (size_t j = 0; j < SimdWidth; ++j)
+                {
+                    bool gt = v[i + j] > best[j];
+                    best[j] = gt ? v[i + j] : best[j];
+                    idx[j] = gt ? i + j : idx[j];
+                }
+            }
+            for (size_t j = 0; i < n; ++i, ++j)
+                if (v[i] > best[j])
+                {
+                    best[j] = v[i];
+                    idx[j] = i;
+                }
+
+            size_t out = 0;
+            for (size_t j = 1; j < SimdWidth; ++j)
+                if (best[j] > best[out] || (best[j] == best[out] && idx[j] < idx[out]))
+                    out = j;
+            return idx[out] < n ? idx[out] : 0;
+        }
+
+        /// @brief Indices of the k smallest values in ascending order of the values, k <= n.
+        /// A value is compared with the worst of the current k first, so most of them cost one comparison
+        template <size_t k>
+        std::array<size_t, k> TopK(const double *v, size_t n)
+        {
+            static_assert(k > 0);
+            std::array<double, k> best;
+            std::array<size_t, k> idx;
+            best.fill(std::numeric_limits<double>::infinity());
+            idx.fill(n);
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (!(v[i] < best[k - 1]))
+                    continue;
+                size_t pos = k - 1;
+                for (; pos > 0 && v[i] < best[pos - 1]; --pos)
+                {
+                    best[pos] = best[pos - 1];
+                    idx[pos] = idx[pos - 1];
+                }
+                best[pos] = v[i];
+                idx[pos] = i;
+            }
+            return idx;
+        }
+
+        /// @brief Value column of a set of PointVal, i.e., the structure of arrays view of the values
+        template <size_t count, typename pointval>
+        std::array<double, count> Values(const SetOfPoints<count, pointval> &s)
+        {
+            std::array<double, count> out;
+            for (size_t i = 0; i < count; ++i)
+                out[i] = s[i].Val;
+            return out;
+        }
+
+        template <size_t count>
+        size_t ArgMin(const std::array<double, count> &v) { return ArgMin(v.data(), count); }
+
+        template <size_t count>
+        size_t ArgMax(const std::array<double, count> &v) { return ArgMax(v.data(), count); }
+
+        template <size_t k, size_t count>
+        std::array<size_t, k> TopK(const std::array<double, count> &v) { return TopK<k>(v.data(), count); }
+
+        template <size_t count, typename pointval>
+        size_t ArgMin(const SetOfPoints<count, pointval> &s) { return ArgMin(Values(s)); }
+
+        template <size_t count, typename pointval>
+        size_t ArgMax(const SetOfPoints<count, pointval> &s) { return ArgMax(Values(s)); }
+
+        template <size_t k, size_t count, typename pointval>
+        std::array<size_t, k> TopK(const SetOfPoints<count, pointval> &s) { return TopK<k>(Values(s)); }
+
+        // sets up to this size are sorted by networks, e.g., simplexes with dim + 1 <= 32
+        constexpr size_t MaxNetworkSize = 32;
+
+        /// @brief Batcher's odd-even merge sort for an arbitrary n. Calls cmp(i, j), i < j, for every comparator
+        template <typename comparator>
+        constexpr void ForEachComparator(size_t n, comparator &&cmp)
+        {
+            for (size_t p = 1; p < n; p *= 2)
+                for (size_t k = p; k >= 1; k /= 2)
+                    for (size_t j = k % p; j + k < n; j += 2 * k)
+                        for (size_t i = 0; i < std::min(k, n - j - k); ++i)
+                            if ((i + j) / (2 * p) == (i + j + k) / (2 * p))
+                                cmp(i + j, i + j + k);
+        }
+
+        template <size_t n>
+        constexpr size_t NetworkSize()
+        {
+            size_t out = 0;
+            ForEachComparator(n, [&out](size_t, size_t) { ++out; });
+            return out;
+        }
+
+        /// @brief Comparators of the sorting network for n keys, generated at compile time
+        template <size_t n>
+        constexpr auto NetworkPairs()
+        {
+            std::array<std::pair<std::uint8_t, std::uint8_t>, NetworkSize<n>()> out{};
+            size_t c = 0;
+            ForEachComparator(n, [&out, &c](size_t i, size_t j)
+                              { out[c++] = {static_cast<std::uint8_t>(i), static_cast<std::uint8_t>(j)}; });
+            return out;
+        }
+
+        /// @brief Sorts the keys in ascending order and permutes idx in the same way.
+        /// Equal keys are ordered by idx, so the sort is stable if idx is initially 0, 1, ..., n - 1
+        template <size_t n>
+        void SortingNetwork(std::array<double, n> &keys, std::array<std::uint8_t, n> &idx)
+        {
+            static_assert(n <= MaxNetworkSize);
+            static constexpr auto pairs{NetworkPairs<n>()};
+
+            auto exchange = [&keys, &idx](size_t i, size_t j)
+            {
+                bool sw = keys[j] < keys[i] || (keys[j] == keys[i] && idx[j] < idx[i]);
+                double ki = keys[i], kj = keys[j];
+                std::uint8_t ii = idx[i], ij = idx[j];
+                keys[i] = sw ? kj : ki;
+                keys[j] = sw ? ki : kj;
+                idx[i] = sw ? ij : ii;
+                idx[j] = sw ? ii : ij;
+            };
+            [&exchange]<size_t... c>(std::index_sequence<c...>)
+            {
+                (exchange(pairs[c].first, pairs[c].second), ...);
+            }(std::make_index_sequence<pairs.size()>{});
+        }
+
+        /// @brief Stable sort of a set of PointVal by Val.
+        /// Small sets are sorted by a network on the value column and the points are moved once,
+        /// larger ones fall back to std::stable_sort
+        template <size_t count, typename pointval>
+        void SortByVal(SetOfPoints<count, pointval> &s)
+        {
+            if constexpr (count <= 1)
+                return;
+            else if constexpr (count <= MaxNetworkSize)
+            {
+                std::array<double, count> keys{Values(s)};
+                std::array<std::uint8_t, count> idx;
+                for (size_t i = 0; i < count; ++i)
+                    idx[i] = static_cast<std::uint8_t>(i);
+
+                SortingNetwork(keys, idx);
+
+                std::array<pointval, count> sorted;
+                for (size_t i = 0; i < count; ++i)
+                    sorted[i] = std::move(s[idx[i]]);
+                for (size_t i = 0; i < count; ++i)
+                    s[i] = std::move(sorted[i]);
+            }
+            else
+                std::stable_sort(s.begin(), s.end(), [](const pointval &l, const pointval &r)
+                                 { return l.Val < r.Val; });
+        }
+    } // Selection
+} // OptLib
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef DISTRIBUTIONS_H
+#define DISTRIBUTIONS_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "../Points/SetOfPoints/PointVals/Point/Point.h"
+
+#include "Philox.h"
+#include "Xoshiro.h"
+
+namespace OptLib
+{
+	namespace Random
+	{
+		/// @brief Block generation of variates. The raw bits are produced by rng::Fill, the conversion
+		/// loops have no dependencies between the elements and vectorize. The results are the same as
+		/// drawing the variates one by one with rng::Uniform
+		namespace Detail
+		{
+			constexpr size_t Chunk = 256;
+
+			/// @brief Raw words per double: Philox gives 32 bits, xoshiro gives 64 bits
+			template<typename rng>
+			constexpr size_t WordsPerDouble = sizeof(typename rng::result_type) == 4 ? 2 : 1;
+
+			template<typename rng>
+			void FillUnit(rng& g, double* out, size_t n)
+			{
+				constexpr size_t w = WordsPerDouble<rng>;
+				std::array<typename rng::result_type, Chunk * w> buf;
+				for (size_t i = 0; i < n; i += Chunk)
+				{
+					const size_t m = std::min(Chunk, n - i);
+					g.Fill(buf.data(), m * w);
+#pragma omp simd
+					for (size_t k = 0; k < m; ++k)
+					{
+						std::uint64_t bits;
+						if constexpr (w == 2)
+							bits = (static_cast<std::uint64_t>(buf[2 * k]) << 32) | buf[2 * k + 1];
+						else
+							bits = buf[k];
+						out[i + k] = static_cast<double>(bits >> 11) * 0x1.0p-53;
+					}
+				}
+			}
+		} // Detail
+
+		/// @brief n uniform variates in [a, b)
+		template<typename rng>
+		void FillUniform(rng& g, double* out, size_t n, double a = 0.0, double b = 1.0)
+		{
+			Detail::FillUnit(g, out, n);
+#pragma omp simd
+			for (size_t i = 0; i < n; ++i)
+				out[i] = a + (b - a) * out[i];
+		}
+
+		/// @brief n words of 32 random bits. A 64-bit generator gives two words per output,
+		/// which halves the cost of the coin flips and the coefficients of the population methods
+		template<typename rng>
+		void FillBits32(rng& g, std::uint32_t* out, size_t n)
+		{
+			if constexpr (sizeof(typename rng::result_type) == 4)
+				g.Fill(out, n);
+			else
+			{
+				std::array<typename rng::result_type, Detail::Chunk> buf;
+				for (size_t i = 0; i < n; i += 2 * Detail::Chunk)
+				{
+					const size_t m = std::min(2 * Detail::Chunk, n - i);
+					const size_t words = (m + 1) / 2;
+					g.Fill(buf.data(), words);
+					for (size_t k = 0; k < m / 2; ++k)
+					{
+						out[i + 2 * k] = static_cast<std::uint32_t>(buf[k]);
+						out[i + 2 * k + 1] = static_cast<std::uint32_t>(buf[k] >> 32);
+					}
+					if (m % 2)
+						out[i + m - 1] = static_cast<std::uint32_t>(buf[words - 1]);
+				}
+			}
+		}
+
+		/// @brief n uniform variates in [a, b) with 32 random bits each, half the cost of FillUniform
+		/// with a 64-bit generator, where the resolution of 2^-32 is enough
+		template<typename rng>
+		void FillUniform32(rng& g, double* out, size_t n, double a = 0.0, double b = 1.0)
+		{
+			std::array<std::uint32_t, 2 * Detail::Chunk> bits;
+			const double scale = (b - a) * 0x1.0p-32;
+			for (size_t i = 0; i < n; i += bits.size())
+			{
+				const size_t m = std::min(bits.size(), n - i);
+				FillBits32(g, bits.data(), m);
+#pragma omp simd
+				for (size_t k = 0; k < m; ++k)
+					out[i + k] = a + scale * static_cast<double>(bits[k]);
+			}
+		}
+
+		/// @brief n normal variates by the Box-Muller transform, two variates per pair of uniforms
+		template<typename rng>
+		void FillNormal(rng& g, double* out, size_t n, double mean = 0.0, double sigma = 1.0)
+		{
+			constexpr double two_pi = 6.283185307179586476925286766559;
+			std::array<double, Detail::Chunk> u;
+			for (size_t i = 0; i < n; i += Detail::Chunk)
+			{
+				const size_t m = std::min(Detail::Chunk, n - i);
+				const size_t pairs = (m + 1) / 2;
+				Detail::FillUnit(g, u.data(), 2 * pairs);
+
+				std::array<double, Detail::Chunk> z;
+#pragma omp simd
+				for (size_t k = 0; k < pairs; ++k)
+				{
+					double r = std::sqrt(-2.0 * std::log(1.0 - u[2 * k])); // 1 - u is in (0, 1]
+					double t = two_pi * u[2 * k + 1];
+					z[2 * k] = r * std::cos(t);
+					z[2 * k + 1] = r * std::sin(t);
+				}
+				for (size_t k = 0; k < m; ++k)
+					out[i + k] = mean + sigma * z[k];
+			}
+		}
+
+		/// @brief Point uniformly distributed in the cube center +- h
+		template<size_t dim, typename rng>
+		Point<dim> UniformPoint(rng& g, const Point<dim>& center, double h)
+		{
+			Point<dim> out;
+			FillUniform(g, &out[0], dim, -h, h);
+			for (size_t i = 0; i < dim; ++i)
+				out[i] += center[i];
+			return out;
+		}
+
+		/// @brief Point normally distributed around center with the standard deviation sigma along every axis
+		template<size_t dim, typename rng>
+		Point<dim> NormalPoint(rng& g, const Point<dim>& center, double sigma)
+		{
+			Point<dim> out;
+			FillNormal(g, &out[0], dim, 0.0, sigma);
+			for (size_t i = 0; i < dim; ++i)
+				out[i] += center[i];
+			return out;
+		}
+	} // Random
+} // OptLib
+
+#endif
@@ -0,0 +1,178 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace OptLib
+{
+	namespace Random
+	{
+		/// @brief Counter-based generator Philox4x32-10 (Salmon et al., 2011).
+		/// The output is a pure function of (key, counter), so streams with different stream ids never overlap
+		/// and a stream gives the same numbers whatever thread runs it. Satisfies UniformRandomBitGenerator
+		class Philox4x32
+		{
+		public:
+			using result_type = std::uint32_t;
+			using counter_type = std::array<std::uint32_t, 4>;
+			using key_type = std::array<std::uint32_t, 2>;
+
+			static constexpr result_type min() { return 0; }
+			static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+			/// @param seed Key of the generator, common for all the streams of a run
+			/// @param stream Id of the stream, e.g., the index of a chain or of a particle
+			Philox4x32(std::uint64_t seed, std::uint64_t stream = 0) :
+				Key{ Lo(seed), Hi(seed) },
+				Counter{ 0, 0, Lo(stream), Hi(stream) }
+			{}
+
+			result_type operator()()
+			{
+				if (Pos == 4)
+				{
+					Buffer = Block(Counter, Key);
+					Increment();
+					Pos = 0;
+				}
+				return Buffer[Pos++];
+			}
+
+			/// @brief Skips n outputs in O(1): the same as n calls of operator()
+			void Discard(std::uint64_t n)
+			{
+				std::uint64_t avail = 4 - Pos;
+				if (n <= avail)
+				{
+					Pos += static_cast<unsigned>(n);
+					return;
+				}
+				n -= avail;
+				Advance(n / 4);
+				Pos = 4;
+				if (unsigned rem = static_cast<unsigned>(n % 4); rem > 0)
+				{
+					(*this)();
+					Pos = rem;
+				}
+			}
+
+			/// @brief Writes the next n outputs, the same as n calls of operator().
+			/// Whole blocks are produced Lanes counters at a time by a vectorizable kernel
+			void Fill(result_type* out, size_t n)
+			{
+				size_t i = 0;
+				for (; i < n && Pos < 4; ++i)
+					out[i] = Buffer[Pos++];
+
+				for (; i + 4 * Lanes <= n; i += 4 * Lanes)
+				{
+					std::array<std::uint32_t, Lanes> c0, c1, c2, c3;
+					for (size_t l = 0; l < Lanes; ++l)
+					{
+						c0[l] = Counter[0]; c1[l] = Counter[1]; c2[l] = Counter[2]; c3[l] = Counter[3];
+						Increment();
+					}
+					BlockLanes(c0, c1, c2, c3);
+					for (size_t l = 0; l < Lanes; ++l)
+					{
+						out[i + 4 * l] = c0[l];
+						out[i + 4 * l + 1] = c1[l];
+						out[i + 4 * l + 2] = c2[l];
+						out[i + 4 * l + 3] = c3[l];
+					}
+				}
+
+				for (; i < n; ++i)
+					out[i] = (*this)();
+			}
+
+			/// @brief Uniform double in [0, 1) with 53 random bits
+			double Uniform()
+			{
+				std::uint64_t a = (*this)();
+				std::uint64_t b = (*this)();
+				return static_cast<double>(((a << 32) | b) >> 11) * 0x1.0p-53;
+			}
+
+			/// @brief Uniform double in [a, b)
+			double Uniform(double a, double b) { return a + (b - a) * Uniform(); }
+
+			/// @brief Ten rounds of Philox applied to the counter
+			static counter_type Block(counter_type ctr, key_type key)
+			{
+				for (int r = 0; r < 10; ++r)
+				{
+					std::uint64_t p0 = static_cast<std::uint64_t>(M0) * ctr[0];
+					std::uint64_t p1 = static_cast<std::uint64_t>(M1) * ctr[2];
+					ctr = counter_type{
+						Hi(p1) ^ ctr[1] ^ key[0], Lo(p1),
+						Hi(p0) ^ ctr[3] ^ key[1], Lo(p0) };
+					key[0] += W0;
+					key[1] += W1;
+				}
+				return ctr;
+			}
+
+			// number of blocks computed together by Fill
+			static constexpr size_t Lanes = 8;
+
+		protected:
+			static constexpr std::uint32_t M0 = 0xD2511F53u;
+			static constexpr std::uint32_t M1 = 0xCD9E8D57u;
+			static constexpr std::uint32_t W0 = 0x9E3779B9u;
+			static constexpr std::uint32_t W1 = 0xBB67AE85u;
+
+			key_type Key;
+			counter_type Counter; // the low 64 bits count blocks, the high 64 bits hold the stream id
+			counter_type Buffer{};
+			unsigned Pos{ 4 };
+
+			void Increment()
+			{
+				if (++Counter[0] == 0)
+					++Counter[1];
+			}
+
+			/// @brief Adds n to the 64-bit block counter
+			void Advance(std::uint64_t n)
+			{
+				std::uint64_t c = ((static_cast<std::uint64_t>(Counter[1]) << 32) | Counter[0]) + n;
+				Counter[0] = Lo(c);
+				Counter[1] = Hi(c);
+			}
+
+			/// @brief Block for Lanes counters stored as structure of arrays
+			void BlockLanes(std::array<std::uint32_t, Lanes>& c0, std::array<std::uint32_t, Lanes>& c1,
+				std::array<std::uint32_t, Lanes>& c2, std::array<std::uint32_t, Lanes>& c3) const
+			{
+#pragma omp simd
+				for (size_t l = 0; l < Lanes; ++l)
+				{
+					std::uint32_t x0 = c0[l], x1 = c1[l], x2 = c2[l], x3 = c3[l];
+					std::uint32_t k0 = Key[0], k1 = Key[1];
+					for (int r = 0; r < 10; ++r)
+					{
+						std::uint64_t p0 = static_cast<std::uint64_t>(M0) * x0;
+						std::uint64_t p1 = static_cast<std::uint64_t>(M1) * x2;
+						x0 = Hi(p1) ^ x1 ^ k0;
+						x2 = Hi(p0) ^ x3 ^ k1;
+						x1 = Lo(p1);
+						x3 = Lo(p0);
+						k0 += W0;
+						k1 += W1;
+					}
+					c0[l] = x0; c1[l] = x1; c2[l] = x2; c3[l] = x3;
+				}
+			}
+
+			static constexpr std::uint32_t Lo(std::uint64_t x) { return static_cast<std::uint32_t>(x); }
+			static constexpr std::uint32_t Hi(std::uint64_t x) { return static_cast<std::uint32_t>(x >> 32); }
+		};
+	} // Random
+} // OptLib
+
+#endif
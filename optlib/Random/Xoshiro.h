@@ -0,0 +1,99 @@
+#ifndef XOSHIRO_H
+#define XOSHIRO_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace OptLib
+{
+	namespace Random
+	{
+		/// @brief xoshiro256++ (Blackman, Vigna, 2019): a fast sequential generator with a period of 2^256 - 1.
+		/// Streams are the subsequences 2^128 outputs apart, they are reached by Jump.
+		/// Satisfies UniformRandomBitGenerator
+		class Xoshiro256pp
+		{
+		public:
+			using result_type = std::uint64_t;
+
+			static constexpr result_type min() { return 0; }
+			static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+			/// @param seed Expanded to the state by SplitMix64
+			/// @param stream Id of the stream. Reaching it costs stream jumps, so ids are expected to be small, e.g., thread indices
+			Xoshiro256pp(std::uint64_t seed, std::uint64_t stream = 0)
+			{
+				for (auto& s : State)
+					s = SplitMix64(seed);
+				for (std::uint64_t i = 0; i < stream; ++i)
+					Jump();
+			}
+
+			result_type operator()()
+			{
+				const std::uint64_t out = Rotl(State[0] + State[3], 23) + State[0];
+				const std::uint64_t t = State[1] << 17;
+				State[2] ^= State[0];
+				State[3] ^= State[1];
+				State[1] ^= State[2];
+				State[0] ^= State[3];
+				State[2] ^= t;
+				State[3] = Rotl(State[3], 45);
+				return out;
+			}
+
+			/// @brief Writes the next n outputs
+			void Fill(result_type* out, size_t n)
+			{
+				for (size_t i = 0; i < n; ++i)
+					out[i] = (*this)();
+			}
+
+			/// @brief Uniform double in [0, 1) with 53 random bits
+			double Uniform() { return static_cast<double>((*this)() >> 11) * 0x1.0p-53; }
+
+			/// @brief Uniform double in [a, b)
+			double Uniform(double a, double b) { return a + (b - a) * Uniform(); }
+
+			/// @brief The same as 2^128 calls of operator()
+			void Jump() { Polynomial({ 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL }); }
+
+			/// @brief The same as 2^192 calls of operator(), e.g., to separate the runs of a multi-start
+			void LongJump() { Polynomial({ 0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL, 0x77710069854ee241ULL, 0x39109bb02acbe635ULL }); }
+
+			const std::array<std::uint64_t, 4>& RawState() const { return State; }
+			void SetRawState(const std::array<std::uint64_t, 4>& s) { State = s; }
+
+		protected:
+			std::array<std::uint64_t, 4> State;
+
+			static constexpr std::uint64_t Rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+			static std::uint64_t SplitMix64(std::uint64_t& x)
+			{
+				std::uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+				z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+				z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+				return z ^ (z >> 31);
+			}
+
+			void Polynomial(const std::array<std::uint64_t, 4>& poly)
+			{
+				std::array<std::uint64_t, 4> s{};
+				for (std::uint64_t p : poly)
+					for (int b = 0; b < 64; ++b)
+					{
+						if (p & (std::uint64_t{ 1 } << b))
+							for (size_t i = 0; i < 4; ++i)
+								s[i] ^= State[i];
+						(*this)();
+					}
+				State = s;
+			}
+		};
+	} // Random
+} // OptLib
+
+#endif
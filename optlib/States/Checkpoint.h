@@ -0,0 +1,224 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../Points/Definitions.h"
+#include "../Functions/Interface/FuncInterface.h"
+
+namespace OptLib
+{
+	/// @brief Binary checkpoints of the states and of Optimizer, e.g., to warm-start a run from the state of the previous one
+	/// or to survive a restart of the process without repeating the evaluations.
+	/// A checkpoint is a header {Magic, Version, tag of the type} followed by the fields of the object in the native byte order,
+	/// so it is read back by a build of the same library for the same platform. The values are stored as their bits:
+	/// a restored state continues exactly the same trajectory as the saved one, random generators included.
+	/// Every state provides its CheckpointTag, see Tag, and template<typename archive> void Serialize(archive& ar), which passes its variable fields to ar(...)
+	/// after the fields of its base. The same function reads and writes. The constant settings of a state, e.g., the coefficients
+	/// of Nelder-Mead, are not stored: they come from the parameters the state is created with. The buffers of a single iteration
+	/// are not stored either, a checkpoint is taken between iterations
+	namespace Checkpoint
+	{
+		// "OPTL"
+		constexpr std::uint32_t Magic = 0x4C54504Fu;
+		// bumped when the fields of any Serialize change, older checkpoints are then rejected
+		constexpr std::uint32_t Version = 2;
+
+		/// @brief Reads (loading == true) or writes the fields passed to operator(). Handles the types with Serialize,
+		/// PointVal, trivially copyable types, e.g., Point and the random generators, std::vector, Eigen matrices
+		/// and fixed-size sets of points. A failed read leaves the archive not Good(), and the rest of the reads are skipped
+		template<bool loading>
+		class Archive
+		{
+		public:
+			using stream_type = std::conditional_t<loading, std::istream, std::ostream>;
+
+			constexpr static bool Loading = loading;
+
+			explicit Archive(stream_type& s) : Stream{ s } {}
+
+			template<typename... T>
+			Archive& operator()(T&... x)
+			{
+				(Item(x), ...);
+				return *this;
+			}
+
+			bool Good() const { return Ok && static_cast<bool>(Stream); }
+
+		protected:
+			stream_type& Stream;
+			bool Ok{ true };
+
+			void Bytes(void* p, size_t n)
+			{
+				if (!Good()) return;
+				if constexpr (loading)
+					Ok = static_cast<size_t>(Stream.read(static_cast<char*>(p), static_cast<std::streamsize>(n)).gcount()) == n;
+				else
+					Stream.write(static_cast<const char*>(p), static_cast<std::streamsize>(n));
+			}
+
+			/// @brief Writes n or reads it back
+			size_t Length(size_t n)
+			{
+				std::uint64_t v = n;
+				Bytes(&v, sizeof(v));
+				return Good() ? static_cast<size_t>(v) : 0;
+			}
+
+			template<typename T>
+			void Item(T& x)
+			{
+				if constexpr (requires { x.Serialize(*this); })
+					x.Serialize(*this);
+				else if constexpr (requires { x.P; x.Val; })
+					(*this)(x.P, x.Val); // PointVal
+				else if constexpr (std::is_trivially_copyable_v<T>)
+					Bytes(&x, sizeof(T));
+				else if constexpr (requires { x.rows(); x.cols(); x.data(); x.resize(0, 0); })
+				{ // Eigen
+					const size_t r = Length(static_cast<size_t>(x.rows()));
+					const size_t c = Length(static_cast<size_t>(x.cols()));
+					if constexpr (loading)
+						x.resize(static_cast<long>(r), static_cast<long>(c));
+					Bytes(x.data(), r * c * sizeof(*x.data()));
+				}
+				else if constexpr (requires { x.data(); x.resize(0); })
+				{ // std::vector
+					const size_t n = Length(x.size());
+					if constexpr (loading)
+					{
+						if constexpr (std::is_default_constructible_v<typename T::value_type>)
+							x.resize(n);
+						else if (n != x.size()) // the size is set by the parameters, e.g., the chains of the parallel tempering
+							Ok = false;
+					}
+					if (!Good()) return;
+					if constexpr (std::is_trivially_copyable_v<typename T::value_type>)
+						Bytes(x.data(), n * sizeof(typename T::value_type));
+					else
+						for (auto& e : x)
+							Item(e);
+				}
+				else
+				{ // a set of a fixed size, e.g., a simplex
+					for (size_t i = 0; i < x.size(); ++i)
+						Item(x[i]);
+				}
+			}
+		};
+
+		using Writer = Archive<false>;
+		using Reader = Archive<true>;
+
+		/// @brief Identifies the type of the saved object, so that a checkpoint of one state is not loaded into another one.
+		/// FNV-1a of the constexpr static const char* CheckpointTag of T, of its arg_count and of the tags of the types listed in
+		/// using CheckpointParts = std::tuple<...>, e.g., the subproblem of the trust region, or a number as std::integral_constant.
+		/// Unlike the name of the type, it is the same with every compiler
+		template<typename T>
+		std::uint64_t Tag(std::uint64_t h = 0xcbf29ce484222325ULL)
+		{
+			auto bytes = [&h](const unsigned char* p, size_t n)
+			{
+				for (size_t i = 0; i < n; ++i)
+					h = (h ^ p[i]) * 0x100000001b3ULL;
+			};
+			auto number = [&bytes](std::uint64_t v)
+			{
+				unsigned char b[8];
+				for (size_t i = 0; i < 8; ++i)
+					b[i] = static_cast<unsigned char>(v >> (8 * i)); // the same on any byte order
+				bytes(b, 8);
+			};
+
+			if constexpr (requires { T::value; })
+				number(static_cast<std::uint64_t>(T::value)); // std::integral_constant
+			else
+			{
+				const char* name = T::CheckpointTag;
+				size_t n = 0;
+				while (name[n]) ++n;
+				bytes(reinterpret_cast<const unsigned char*>(name), n + 1); // with the terminator, "ab" + "c" differs from "a" + "bc"
+				if constexpr (requires { T::arg_count; })
+					number(T::arg_count);
+				if constexpr (requires { typename T::CheckpointParts; })
+					[&h]<typename... part>(std::tuple<part...>*)
+					{
+						((h = Tag<part>(h)), ...);
+					}(static_cast<typename T::CheckpointParts*>(nullptr));
+			}
+			return h;
+		}
+
+		/// @brief Writes the checkpoint of a state or of an Optimizer
+		/// @return false if the stream failed
+		template<typename T>
+		bool Save(const T& Obj, std::ostream& out)
+		{
+			std::uint32_t magic = Magic, version = Version;
+			std::uint64_t tag = Tag<T>();
+			Writer ar{ out };
+			ar(magic, version, tag);
+			const_cast<T&>(Obj).Serialize(ar); // Serialize only reads the fields when it writes
+			return ar.Good();
+		}
+
+		/// @brief Reads a checkpoint written by Save into an object of the same type created with the same parameters
+		/// @return false if the stream fails or holds a checkpoint of another version or type.
+		/// The object is then partially overwritten, see Restore for a state that is only created on success
+		template<typename T>
+		bool Load(T& Obj, std::istream& in)
+		{
+			std::uint32_t magic = 0, version = 0;
+			std::uint64_t tag = 0;
+			Reader ar{ in };
+			ar(magic, version, tag);
+			if (!ar.Good() || magic != Magic || version != Version || tag != Tag<T>())
+				return false;
+			Obj.Serialize(ar);
+			return ar.Good();
+		}
+
+		/// @brief Zero function with zero derivatives. A state created on it costs no real evaluation and is overwritten by Load
+		template<size_t dim>
+		class Placeholder : public FuncInterface::IFuncWithHess<dim>
+		{
+		public:
+			double operator()(const Point<dim>&) const override { return 0.0; }
+			Grad<dim> grad(const Point<dim>&) const override { return Grad<dim>{}; }
+			Hess<dim> hess(const Point<dim>&) const override { return Hess<dim>{}; }
+		};
+
+		/// @brief Creates the state of prm on f and loads the checkpoint into it. The values f returns on the creation are overwritten,
+		/// so f may be a Placeholder unless the state needs a concrete type of function, e.g., LeastSquares
+		/// @return The state, or nothing if the checkpoint is not read
+		template<typename params, typename func>
+		std::optional<typename params::StateType> Restore(params prm, std::istream& in, func* f)
+		{
+			std::optional<typename params::StateType> out{ prm.CreateState(f) };
+			if (!Load(*out, in))
+				out.reset();
+			return out;
+		}
+
+		/// @brief Restores a state without a single evaluation of the objective
+		template<typename params>
+		std::optional<typename params::StateType> Restore(params prm, std::istream& in)
+		{
+			Placeholder<params::StateType::arg_count> f;
+			return Restore(std::move(prm), in, &f);
+		}
+	} // Checkpoint
+} // OptLib
+
+#endif
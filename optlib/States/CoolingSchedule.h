@@ -0,0 +1,125 @@
+#ifndef COOLINGSCHEDULE_H
+#define COOLINGSCHEDULE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+namespace OptLib
+{
+	/// @brief Cooling schedules of the simulated annealing. A schedule is a template parameter of the state,
+	/// so its calls are inlined. Every schedule provides
+	///   void Start(double T0) - called once with the initial temperature;
+	///   double Next(double T, size_t k) - the temperature of the k-th step (k >= 1) after the temperature T;
+	///   void Observe(bool accepted, double& h) - the outcome of every Metropolis test, h is the proposal half-width.
+	namespace CoolingSchedule
+	{
+		/// @brief T_k = alpha * T_{k-1}
+		struct Geometric
+		{
+			constexpr static const char* CheckpointTag = "Geometric";
+
+			double Alpha{ 0.99 };
+
+			void Start(double) {}
+			double Next(double T, size_t) const { return Alpha * T; }
+			void Observe(bool, double&) {}
+		};
+
+		/// @brief T_k = T_0 ln 2 / ln(k + 2), the classic schedule with the convergence guarantee (Geman, Geman, 1984).
+		/// It is very slow, so it mostly suits short runs at a low temperature
+		struct Logarithmic
+		{
+			constexpr static const char* CheckpointTag = "Logarithmic";
+
+			double T0{ 1.0 };
+
+			void Start(double t0) { T0 = t0; }
+			double Next(double, size_t k) const { return T0 * std::log(2.0) / std::log(static_cast<double>(k) + 2.0); }
+			void Observe(bool, double&) {}
+		};
+
+		/// @brief T_k = T_{k-1} / (1 + beta T_{k-1}) (Lundy, Mees, 1986): fast in the hot phase and slow in the cold one
+		struct LundyMees
+		{
+			constexpr static const char* CheckpointTag = "LundyMees";
+
+			double Beta{ 1E-3 };
+
+			void Start(double) {}
+			double Next(double T, size_t) const { return T / (1.0 + Beta * T); }
+			void Observe(bool, double&) {}
+		};
+
+		/// @brief Any callable double(double T, size_t k), e.g., a lambda, which is inlined unlike a function pointer
+		template<typename F>
+		struct Custom
+		{
+			constexpr static const char* CheckpointTag = "Custom";
+
+			F Fn;
+
+			void Start(double) {}
+			double Next(double T, size_t k) const { return Fn(T, k); }
+			void Observe(bool, double&) {}
+		};
+
+		template<typename F>
+		Custom(F) -> Custom<F>;
+
+		/// @brief Wraps a cooling schedule and tunes the proposal half-width h to keep the acceptance rate at Target.
+		/// After every Window tests h is multiplied by exp(Gain (rate - Target)): a too hot phase, where almost everything
+		/// is accepted, makes longer steps, a too cold one, where almost everything is rejected, makes shorter steps.
+		/// If the rate stays above MaxRate the temperature is additionally divided by Speedup, as the chain is then
+		/// a random walk that wastes the evaluations
+		template<typename schedule = Geometric>
+		struct AdaptiveStep
+		{
+			constexpr static const char* CheckpointTag = "AdaptiveStep";
+			using CheckpointParts = std::tuple<schedule>;
+
+			schedule Base{};
+			double Target{ 0.44 };
+			size_t Window{ 50 };
+			double Gain{ 1.0 };
+			double MaxRate{ 0.9 };
+			double Speedup{ 2.0 };
+
+			size_t Tests{ 0 };
+			size_t Accepted{ 0 };
+			double Rate{ 0.0 }; // the acceptance rate of the last complete window
+			bool Hot{ false };
+
+			void Start(double T0) { Base.Start(T0); }
+
+			double Next(double T, size_t k)
+			{
+				double t = Base.Next(T, k);
+				if (Hot)
+				{
+					Hot = false;
+					t /= Speedup;
+				}
+				return t;
+			}
+
+			void Observe(bool accepted, double& h)
+			{
+				Base.Observe(accepted, h);
+				Accepted += accepted;
+				if (++Tests < Window)
+					return;
+
+				Rate = static_cast<double>(Accepted) / static_cast<double>(Tests);
+				h *= std::exp(Gain * (Rate - Target));
+				Hot = Rate > MaxRate;
+				Tests = 0;
+				Accepted = 0;
+			}
+		};
+	} // CoolingSchedule
+} // OptLib
+
+#endif
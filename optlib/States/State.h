@@ -2,12 +2,17 @@
 #define STATE_H
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <tuple>
 #include "../Points/SetOfPoints/PointVals/Point/Point.h"
 #include "../Points/SetOfPoints/PointVals/PointVal.h"
 #include "../Points/SetOfPoints/SetOfPoints.h"
 #include "../Points/Definitions.h"
 #include "../Functions/Interface/FuncInterface.h"
 #include "StateInterface.h"
+#include "CoolingSchedule.h"
+#include "../Random/Distributions.h"
 
 namespace OptLib
 {
@@ -25,15 +30,23 @@ namespace OptLib
 		class StateSegment : public StateInterface::IStateSimplex<1, SimplexValNoSort<1>>
 		{
 		public:
+			constexpr static const char* CheckpointTag = "Segment";
 			StateSegment(const StateSegment&) = default;
 			StateSegment(const Simplex<1>& State, const FuncInterface::IFunc<1>* f)
 				:
 				StateInterface::IStateSimplex<1, SimplexValNoSort<1>>(
 					OrderPointsInSegment(State), f)
 			{}
+			/// @brief Reuses a segment whose end points are already evaluated, e.g., a bracket of a line search
+			StateSegment(SimplexVal<1>&& State)
+				:
+				StateInterface::IStateSimplex<1, SimplexValNoSort<1>>(
+					OrderPointsInSegment(std::move(State)))
+			{}
 
 		protected:
-			auto OrderPointsInSegment(Simplex<1> setOfPoints) -> Simplex<1>
+			template<typename segment>
+			static auto OrderPointsInSegment(segment setOfPoints) -> segment
 			{
 				if (setOfPoints[0][0] > setOfPoints[1][0])
 					std::swap(setOfPoints[0], setOfPoints[1]);
@@ -53,19 +66,20 @@ namespace OptLib
 			using Base::ItsGuess;
 			PointVal<dim> dx{};
 		public:
+			constexpr static const char* CheckpointTag = "Point";
 
 			using StateInterface::IState<dim>::IState;
 
 			bool IsConverged(double abs_tol, double rel_tol) const override
 			{
-				auto& std = dx;
-				auto var{ abs<dim>(dx / Guess()) };
+				const auto& x = Guess();
+				// |dx / x| < rel_tol is checked without division, so zero coordinates are allowed
 				for (size_t i = 0; i < dim; ++i)
 				{
-					bool f = (std[i] < abs_tol) || (var[i] < rel_tol);
+					bool f = (dx[i] < abs_tol) || (dx[i] < rel_tol * std::abs(x[i]));
 					if (!f) return false;
 				}
-				return (std.Val < abs_tol) || (var.Val < rel_tol);
+				return (dx.Val < abs_tol) || (dx.Val < rel_tol * std::abs(x.Val));
 			}
 
 			virtual void UpdateState(const PointVal<dim>& v)
@@ -73,76 +87,105 @@ namespace OptLib
 				dx = abs<dim>(v - Guess());
 				ItsGuess = v;
 			}
+
+			template<typename archive>
+			void Serialize(archive& ar)
+			{
+				Base::Serialize(ar);
+				ar(dx);
+			}
 		};
 
 		/// <summary>
 		/// Stochastic methods require multiple initial points
 		/// </summary>
-		template<size_t dim>
+		/// @tparam schedule Cooling schedule, see CoolingSchedule.h
+		template<size_t dim, typename schedule = CoolingSchedule::Geometric>
 		class StateStochastic : public StateInterface::IState<dim>
 		{
 		protected:
 			using Base = StateInterface::IState<dim>;
-			using Base::Guess;
 			using Base::ItsGuess;
 		protected:
-			double(*Temperature) (double, int);
-			int iteration;
+			schedule ItsSchedule;
+			size_t iteration;
 			double endTemperature;
 			double h;
 		public:
+			constexpr static const char* CheckpointTag = "Stochastic";
+			using CheckpointParts = std::tuple<schedule>;
+			using func_type = FuncInterface::IFunc<dim>;
+			using schedule_type = schedule;
+			using Base::Guess;
+
+			Random::Philox4x32 Rng;
 			double temperature;
-			PointVal<dim> NextRandomState()
+			/// @brief Neighbour of the current guess uniformly distributed in the cube +- h.
+			/// Only the point is returned: its value is not known until it is evaluated
+			Point<dim> NextRandomState()
 			{
-				PointVal<dim> x = Guess();
-				for (int i = 0; i < dim; i++) {
-					double r = ((double)rand() / RAND_MAX);
-					x.P[i] = 2.0 * r * h + x.P[i] - h;
-				}
-				return x;
+				return Random::UniformPoint(Rng, Guess().P, h);
 			}
 			PointVal<dim> bestGuess;
 			StateStochastic(
 				OptLib::Point<dim>&& State, 
-				FuncInterface::IFunc<dim>* f, 
+				const func_type* f, 
 				double initialTemperature, 
-				double (*TemperatureFunction) (double, int), 
+				schedule TemperatureSchedule, 
 				double step, 
-				double temperature_end) :
-				//StateInterface::IState<dim>(std::move(State), f), 
-				temperature{ initialTemperature }, Temperature{ TemperatureFunction }, h{ step }, endTemperature{ temperature_end },iteration{ 0 } 
+				double temperature_end,
+				std::uint64_t seed = 0) :
+				Base{ FuncInterface::CreateFromPoint<dim>(std::move(State), f) },
+				ItsSchedule{ std::move(TemperatureSchedule) }, iteration{ 0 }, endTemperature{ temperature_end }, h{ step },
+				Rng{ seed }, temperature{ initialTemperature }, bestGuess{ Guess() }
 			{
-				ItsGuess = FuncInterface::CreateFromPoint(std::move(State), f);
-				bestGuess = ItsGuess;
+				ItsSchedule.Start(initialTemperature);
 			}
 			bool IsConverged(double endTemperature, double) const override
 			{
 				return temperature < endTemperature;
 			}
+			/// @brief Current half-width of the proposal, an adaptive schedule changes it
+			double Step() const { return h; }
+			const schedule& Schedule() const { return ItsSchedule; }
 			void ChangeGuess(const PointVal<dim>& currentGuess) {
 				ItsGuess = currentGuess;
 			}
-			void UpdateState()
+			/// @brief Advances the temperature by one step of the schedule
+			void CoolDown()
 			{
 				iteration++;
-				temperature = Temperature(temperature, iteration);
-				PointVal<dim> currentGuess = NextRandomState(); //{ FuncInterface::CreateFromPoint(NextRandomState(Guess().P, h), f) };
-				//UpdateState();
-				double dp = exp((Guess().Val - currentGuess.Val) / temperature);
-				if (dp > 1)
-				{
+				temperature = ItsSchedule.Next(temperature, iteration);
+			}
+			/// @brief Reports the outcome of a Metropolis test to the schedule
+			void Observe(bool accepted)
+			{
+				ItsSchedule.Observe(accepted, h);
+			}
+			/// @brief Metropolis test of a candidate with the value val against the current guess
+			bool Accept(double val)
+			{
+				double d = Guess().Val - val;
+				bool a = d >= 0.0 || Rng.Uniform() < std::exp(d / temperature);
+				Observe(a);
+				return a;
+			}
+			/// @brief One step of the annealing with an evaluated candidate
+			void UpdateState(const PointVal<dim>& currentGuess)
+			{
+				CoolDown();
+				if (Accept(currentGuess.Val))
 					ChangeGuess(currentGuess);
-				}
-				else
-				{
-					double p = (double)rand() / RAND_MAX;
-					if (dp > p)
-					{
-						ChangeGuess(currentGuess);
-					}
-				}
 				if (currentGuess < bestGuess) bestGuess = currentGuess;
 			}
+
+			/// @brief The schedule, the temperature, the step and the generator, so the restored chain draws the same numbers
+			template<typename archive>
+			void Serialize(archive& ar)
+			{
+				Base::Serialize(ar);
+				ar(ItsSchedule, iteration, endTemperature, h, Rng, temperature, bestGuess);
+			}
 		};
 	} // ConcreteState
 } // OptLib
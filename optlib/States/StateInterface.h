@@ -1,9 +1,15 @@
 #ifndef STATEINTERFACE_H
 #define STATEINTERFACE_H
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+
 #include "../Points/SetOfPoints/PointVals/Point/Point.h"
 #include "../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../Points/SetOfPoints/PointVals/PointValOperators.h"
 #include "../Points/SetOfPoints/SetOfPoints.h"
+#include "../Points/SetOfPoints/RunningDispersion.h"
 #include "../Points/Definitions.h"
 
 #include "../Functions/Interface/FuncInterface.h"
@@ -33,12 +39,18 @@ namespace OptLib
 			{}
 
 			IState(const IState&) noexcept = default;
+			// without it, the constructor from a point would take an rvalue state
+			IState(IState&&) noexcept = default;
 
 			// concrete implementation depends on the order of optimization method
 			virtual bool IsConverged(double abs_tol, double rel_tol) const = 0;
 			const auto& Guess() const { return ItsGuess; };
 			const auto& Point() const { return Guess().P; };
 			const auto& Value() const { return Guess().Val; };
+
+			/// @brief Reads or writes the variable fields of the state, see Checkpoint.h
+			template<typename archive>
+			void Serialize(archive& ar) { ar(ItsGuess); }
 		};
 
 		/// @brief State for methods of optimization in dim-dimensional space based on simplexes
@@ -48,6 +60,7 @@ namespace OptLib
 		class IStateSimplex : public IState<dim>
 		{
 			using Base = IState<dim>;
+		protected:
 			using Base::ItsGuess;
 
 		public: // overriden from predecessor
@@ -56,18 +69,29 @@ namespace OptLib
 
 			bool IsConverged(double abs_tol, double rel_tol) const override
 			{// is average and relative tolerance met?
-				auto [avg, disp] = GuessDomain().dispersion();
-				auto [var, std] = var_coef<PointVal<dim>>(avg, disp) ;
+				auto [avg, disp] = ItsDispersion.dispersion();
+				PointVal<dim> sd{ sqrt(disp) };
 
+				// sd / |avg| < rel_tol is checked without division, so a zero average is allowed
 				for (size_t i = 0; i < dim; ++i)
 				{
-					bool f = ((std[i]) < abs_tol) || (var[i] < rel_tol);
+					bool f = (sd[i] < abs_tol) || (sd[i] < rel_tol * std::abs(avg[i]));
 					if (!f) return false;
 				}
-				return (std.Val < abs_tol) || (var.Val < rel_tol);
+				return (sd.Val < abs_tol) || (sd.Val < rel_tol * std::abs(avg.Val));
 			}
 		protected:
 			simplex ItsGuessDomain; // the field is unique for direct optimization methods
+			RunningDispersion<dim + 1, PointVal<dim>> ItsDispersion; // statistics of ItsGuessDomain for IsConverged
+			size_t SinceRecenter{ 0 };
+			size_t RecenterPeriod{ 8 * (dim + 1) }; // an exact recalculation every RecenterPeriod replacements costs O(dim) per replacement
+
+			void Recenter()
+			{
+				ItsDispersion.Reset(GuessDomain());
+				SinceRecenter = 0;
+				ItsGuess = ItsDispersion.mean();
+			}
 			auto FuncVals(const Simplex<dim>& State, const FuncInterface::IFunc<dim>* f) 
 			{
 				return (*f)(State);
@@ -86,7 +110,9 @@ namespace OptLib
 			IStateSimplex(SimplexVal<dim>&& State) :
 				IState<dim>{State.mean()},
 				ItsGuessDomain{State}
-			{ }
+			{
+				Recenter();
+			}
 
 			IStateSimplex(const Simplex<dim>& State, const FuncInterface::IFunc<dim>* f) : 
 				IStateSimplex{State, FuncVals(State, f)}
@@ -97,11 +123,56 @@ namespace OptLib
 			{ }
 			
 			const simplex& GuessDomain() const { return ItsGuessDomain; } // unique for direct optimization methods
+
+			template<typename archive>
+			void Serialize(archive& ar)
+			{
+				Base::Serialize(ar);
+				ar(ItsGuessDomain, ItsDispersion, SinceRecenter, RecenterPeriod);
+			}
 			
+			/// @brief Substitutes the domain. The methods change a few vertices in their places before the domain is sorted,
+			/// so the changed vertices are found by their positions and only they update the statistics, in O(dim) each.
+			/// The statistics are recalculated if most of the vertices have changed, e.g., after squeezing, or every RecenterPeriod replacements
 			virtual void SetDomain(SimplexVal<dim>&& newDomain)
 			{
+				std::array<bool, dim + 1> changed{};
+				size_t n = 0;
+				for (size_t i = 0; i <= dim; ++i)
+				{
+					const PointVal<dim>& a = newDomain[i];
+					const PointVal<dim>& b = GuessDomain()[i];
+					changed[i] = !(a.Val == b.Val && std::equal(a.P.cbegin(), a.P.cend(), b.P.cbegin()));
+					n += changed[i];
+				}
+
+				if (2 * n > dim + 1 || SinceRecenter + n >= RecenterPeriod)
+				{
+					ItsGuessDomain = simplex{ std::move(newDomain) };
+					Recenter();
+					return;
+				}
+				for (size_t i = 0; i <= dim; ++i)
+					if (changed[i])
+						ItsDispersion.Replace(GuessDomain()[i], newDomain[i]);
+				SinceRecenter += n;
 				ItsGuessDomain = simplex{ std::move(newDomain) };
-				ItsGuess = GuessDomain().mean();
+				ItsGuess = ItsDispersion.mean();
+			}
+
+			/// @brief Substitutes the i-th point of the domain. The guess and the statistics are updated in O(dim)
+			virtual void ReplaceVertex(size_t i, PointVal<dim>&& v)
+			{
+				ItsDispersion.Replace(GuessDomain()[i], v);
+				if constexpr (requires { ItsGuessDomain.Replace(i, std::move(v)); })
+					ItsGuessDomain.Replace(i, std::move(v)); // keeps the domain sorted
+				else
+					ItsGuessDomain[i] = std::move(v);
+
+				if (++SinceRecenter >= RecenterPeriod)
+					Recenter();
+				else
+					ItsGuess = ItsDispersion.mean();
 			}
 		};
 	} // StateInterface
@@ -0,0 +1,131 @@
+#ifndef STATEPOPULATION_H
+#define STATEPOPULATION_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+#include "../Points/SetOfPoints/PointVals/Point/Point.h"
+#include "../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../Points/SetOfPoints/Population.h"
+#include "../Points/SetOfPoints/Selection.h"
+#include "../Functions/Interface/FuncInterface.h"
+#include "StateInterface.h"
+#include "../Random/Distributions.h"
+
+namespace OptLib
+{
+	namespace StateInterface
+	{
+		/// @brief State of the population methods: the population X with its values FX in the box [Lower, Upper].
+		/// The guess is the best individual found so far
+		template<size_t dim>
+		class StatePopulation : public IState<dim>
+		{
+		protected:
+			using Base = IState<dim>;
+			using Base::ItsGuess;
+
+			Point<dim> ItsLower;
+			Point<dim> ItsUpper;
+			Point<dim> ItsAvg{};
+			Point<dim> ItsStd{};
+			size_t Generation{ 0 };
+
+			// the population as points, to evaluate it as one batch
+			std::vector<Point<dim>> Points;
+
+		public:
+			using func_type = FuncInterface::IFunc<dim>;
+			using Base::Guess;
+
+			Population<dim> X;
+			std::vector<double> FX;
+			// the sequential generator is the fastest way to draw the O(Size dim) variates of a generation
+			Random::Xoshiro256pp Rng;
+
+			/// @brief The population is drawn uniformly from the box and evaluated
+			StatePopulation(Point<dim>&& lower, Point<dim>&& upper, const func_type* f, size_t size, std::uint64_t seed) :
+				Base{ PointVal<dim>{} },
+				ItsLower{ std::move(lower) },
+				ItsUpper{ std::move(upper) },
+				X(std::max<size_t>(size, 4)),
+				FX(X.Size()),
+				Rng{ seed }
+			{
+				for (size_t i = 0; i < dim; ++i)
+					Random::FillUniform(Rng, X.Axis(i), X.Size(), ItsLower[i], ItsUpper[i]);
+				Evaluate(f, X, FX.data());
+				size_t b = Selection::ArgMin(FX.data(), FX.size());
+				ItsGuess = PointVal<dim>{ X.Get(b), FX[b] };
+			}
+
+			size_t Size() const { return X.Size(); }
+			size_t Generations() const { return Generation; }
+			const Point<dim>& Lower() const { return ItsLower; }
+			const Point<dim>& Upper() const { return ItsUpper; }
+
+			/// @brief The standard deviation of the population along every axis is below the tolerance
+			bool IsConverged(double abs_tol, double rel_tol) const override
+			{
+				if (Generation == 0) return false;
+				for (size_t i = 0; i < dim; ++i)
+				{
+					bool f = (ItsStd[i] < abs_tol) || (ItsStd[i] < rel_tol * std::abs(ItsAvg[i]));
+					if (!f) return false;
+				}
+				return true;
+			}
+
+			/// @brief Evaluates all the individuals of P as one batch across the threads
+			void Evaluate(const func_type* f, const Population<dim>& P, double* out)
+			{
+				FuncInterface::EvaluateParallel<dim>(f, Gather(P).data(), out, P.Size());
+			}
+
+			/// @brief The individuals of P as points, valid until the next call
+			const std::vector<Point<dim>>& Gather(const Population<dim>& P)
+			{
+				P.Gather(Points);
+				return Points;
+			}
+
+			/// @brief Projects the i-th coordinates of n individuals onto the box
+			void Clamp(size_t i, double* a, size_t n) const
+			{
+				const double lo = ItsLower[i];
+				const double hi = ItsUpper[i];
+#pragma omp simd
+				for (size_t k = 0; k < n; ++k)
+					a[k] = std::min(std::max(a[k], lo), hi);
+			}
+
+			/// @brief Uniform index in [0, n), n < 2^32, from 32 random bits by a multiplication instead of a division
+			std::uint32_t Index(size_t n)
+			{
+				return static_cast<std::uint32_t>(((Rng() >> 32) * n) >> 32);
+			}
+
+			/// @brief Ends a generation: takes the best of the candidates P with the values v and the statistics of P
+			void UpdateState(const Population<dim>& P, const std::vector<double>& v)
+			{
+				size_t b = Selection::ArgMin(v.data(), v.size());
+				if (v[b] < ItsGuess.Val)
+					ItsGuess = PointVal<dim>{ P.Get(b), v[b] };
+				std::tie(ItsAvg, ItsStd) = P.Dispersion();
+				++Generation;
+			}
+
+			template<typename archive>
+			void Serialize(archive& ar)
+			{
+				Base::Serialize(ar);
+				ar(ItsLower, ItsUpper, ItsAvg, ItsStd, Generation, X, FX, Rng);
+			}
+		};
+	} // StateInterface
+} // OptLib
+
+#endif
@@ -1,10 +1,15 @@
 #ifndef STATEWITHMEMORY_H
 #define STATEWITHMEMORY_H
 
+#include <algorithm>
+#include <cassert>
+#include <tuple>
+#include <utility>
 #include <vector>
-#include "../Points/SetOfPoints/PointVal/PointVal.h"
+
+#include "../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../Points/SetOfPoints/SetOfPoints.h"
 #include "../Points/Definitions.h"
-#include "../Functions/Interface/FuncInterface.h"
 #include "StateInterface.h"
 #include "State.h"
 
@@ -12,58 +17,203 @@ namespace OptLib
 {
 	namespace StateWithMemory
 	{
-		template<size_t dim,  typename state = StateInterface::IStateSimplex<dim, SimplexValSort<dim>>>
-		class StateSimplexMemory : public state
+		/// @brief What Trajectory does when it is full
+		enum class Overflow
+		{
+			// the oldest record is replaced, the last Capacity records are kept
+			Overwrite,
+			// every second record is dropped and the stride is doubled, the records span the whole run
+			// with a resolution that halves every time the buffer fills up
+			Decimate
+		};
+
+		/// @brief A recorded step: the points of the state after its Iteration-th update
+		/// @tparam count 1 for the guess of a point state, dim + 1 for the domain of a simplex state
+		template<size_t dim, size_t count>
+		struct Snapshot
 		{
-			state* State;
+			size_t Iteration{ 0 };
+			// calls of f so far if the recorder knows them, otherwise 0
+			size_t Evaluations{ 0 };
+			SetOfPoints<count, PointVal<dim>> Points{};
+		};
 
+		/// @brief Bounded record of a trajectory. All Capacity records are allocated by the constructor and reused,
+		/// so recording never allocates and costs a copy of count points per stored record.
+		/// Every Stride-th update is stored, the rest only advance the counter
+		template<size_t dim, size_t count = 1>
+		class Trajectory
+		{
 		public:
-			StateSimplexMemory(state* State, const FuncInterface::IFunc<dim>* f) : 
-				state(State->GuessDomain().PointsNoVal(), f), 
-				State{ State }
+			using record_type = Snapshot<dim, count>;
+
+			/// @param capacity Number of the records kept, at least 2
+			/// @param stride Every stride-th update is stored, 1 stores all of them
+			explicit Trajectory(size_t capacity, Overflow policy = Overflow::Overwrite, size_t stride = 1) :
+				Slots(std::max<size_t>(capacity, 2)),
+				Policy{ policy },
+				ItsStride{ std::max<size_t>(stride, 1) }
+			{}
+
+			size_t Capacity() const { return Slots.size(); }
+			size_t Size() const { return Count; }
+			/// @brief Number of the updates seen, stored or not
+			size_t Updates() const { return Seen; }
+			size_t Stride() const { return ItsStride; }
+
+			/// @brief The i-th oldest stored record
+			const record_type& operator[](size_t i) const
+			{
+				assert(i < Count);
+				return Slots[(Head + i) % Capacity()];
+			}
+			const record_type& Last() const { return (*this)[Count - 1]; }
+
+			void Clear()
+			{
+				Head = 0;
+				Count = 0;
+				Seen = 0;
+			}
+
+			/// @brief Accounts for an update of the state with the points p
+			void Record(const SetOfPoints<count, PointVal<dim>>& p, size_t evaluations = 0)
 			{
-				a_Memory.push_back(*State); // copies current state to a memory
+				Store(Seen, evaluations, p);
 			}
-			const std::vector<state>& Memory() const { return a_Memory; }
 
-			void SetDomain(SetOfPoints<dim + 1, PointVal<dim>>&& newDomain) override
+			/// @brief Takes a record made elsewhere, e.g., read from a TrajectoryLog. The updates between the last record and r
+			/// are counted as seen
+			void Record(const record_type& r)
 			{
-				(*State).SetDomain(std::move(newDomain));
-				a_Memory.push_back(*State); // copies updated state to a memory
+				Store(r.Iteration, r.Evaluations, r.Points);
+			}
+
+			/// @brief Records the domain of a simplex state or the guess of any other state
+			template<typename state>
+				requires requires (const state& s) { s.Guess(); }
+			void Record(const state& State, size_t evaluations = 0)
+			{
+				if constexpr (count == 1)
+					Record(SetOfPoints<1, PointVal<dim>>{ State.Guess() }, evaluations);
+				else
+					Record(State.GuessDomain(), evaluations);
 			}
 
 		protected:
-			mutable std::vector<state> a_Memory;
+			std::vector<record_type> Slots;
+			size_t Head{ 0 };
+			size_t Count{ 0 };
+			size_t Seen{ 0 };
+			Overflow Policy;
+			size_t ItsStride;
+
+			void Store(size_t it, size_t evaluations, const SetOfPoints<count, PointVal<dim>>& p)
+			{
+				Seen = it + 1;
+				if (it % ItsStride != 0)
+					return;
+				if (Count == Capacity())
+				{
+					if (Policy == Overflow::Overwrite)
+					{
+						Head = (Head + 1) % Capacity();
+						--Count;
+					}
+					else
+					{
+						Decimate();
+						if (it % ItsStride != 0)
+							return;
+					}
+				}
+				record_type& r = Slots[(Head + Count) % Capacity()];
+				r.Iteration = it;
+				r.Evaluations = evaluations;
+				r.Points = p;
+				++Count;
+			}
+
+			/// @brief Keeps the records with even positions. They are the updates divisible by the doubled stride,
+			/// as the buffer is never wrapped in this mode
+			void Decimate()
+			{
+				for (size_t i = 1; 2 * i < Count; ++i)
+					Slots[i] = Slots[2 * i];
+				Count = (Count + 1) / 2;
+				ItsStride *= 2;
+			}
 		};
 
-		/// <summary>
-		/// A State that memorizes all its previous states for StatePoint
-		/// </summary>
-		template<size_t dim>
-		class StatePointImproved : public ConcreteState::StatePoint<dim>
+		/// @brief Simplex state that records its domain after every change. Replaces the copies of the whole state
+		/// by a Trajectory of a fixed size
+		/// @tparam state A state derived from IStateSimplex, e.g., ConcreteState::StateNelderMead<dim>
+		template<typename state>
+		class StateSimplexMemory : public state
 		{
-			ConcreteState::StatePoint<dim>* State;
-
 		public:
-			StatePointImproved(ConcreteState::StatePoint<dim>* State) : State{ State }
+			constexpr static const char* CheckpointTag = "SimplexMemory";
+			using CheckpointParts = std::tuple<state>;
+			constexpr static size_t dim = state::arg_count;
+			using memory_type = Trajectory<dim, dim + 1>;
+
+			/// @param State A created state, e.g., the result of CreateState of its parameters
+			StateSimplexMemory(state&& State, memory_type&& memory) :
+				state{ std::move(State) },
+				ItsMemory{ std::move(memory) }
 			{
-				a_Memory.push_back(new ConcreteState::StatePoint<dim>(*State)); // copies current state to a memory
+				ItsMemory.Record(this->GuessDomain());
 			}
 
-			void UpdateState(const PointVal<dim>& v) override
+			const memory_type& Memory() const { return ItsMemory; }
+
+			void SetDomain(SimplexVal<dim>&& newDomain) override
 			{
-				(*State).UpdateState(v);
-				a_Memory.push_back(new ConcreteState::StatePoint<dim>(*State)); // copies updated state to a memory
+				state::SetDomain(std::move(newDomain));
+				ItsMemory.Record(this->GuessDomain());
 			}
 
-			const std::vector<ConcreteState::StatePoint<dim>*>& Memory() { return a_Memory; }
+			void ReplaceVertex(size_t i, PointVal<dim>&& v) override
+			{
+				state::ReplaceVertex(i, std::move(v));
+				ItsMemory.Record(this->GuessDomain());
+			}
 
 		protected:
-			std::vector<ConcreteState::StatePoint<dim>*> a_Memory;
+			memory_type ItsMemory;
 		};
 
+		/// @brief Point state that records its guess after every move
+		/// @tparam state A state derived from StatePoint, e.g., ConcreteState::StateGradient<dim>
+		template<typename state>
+		class StatePointMemory : public state
+		{
+		public:
+			constexpr static const char* CheckpointTag = "PointMemory";
+			using CheckpointParts = std::tuple<state>;
+			constexpr static size_t dim = state::arg_count;
+			using memory_type = Trajectory<dim, 1>;
+
+			StatePointMemory(state&& State, memory_type&& memory) :
+				state{ std::move(State) },
+				ItsMemory{ std::move(memory) }
+			{
+				ItsMemory.Record(*this);
+			}
+
+			const memory_type& Memory() const { return ItsMemory; }
 
+			using state::UpdateState;
+			void UpdateState(const PointVal<dim>& v) override
+			{
+				state::UpdateState(v);
+				ItsMemory.Record(*this);
+			}
+
+		protected:
+			memory_type ItsMemory;
+		};
 	} // StateWithMemory
 } // OptLib
 
-#endif
\ No newline at end of file
+#endif
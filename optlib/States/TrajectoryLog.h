@@ -0,0 +1,309 @@
+#ifndef TRAJECTORYLOG_H
+#define TRAJECTORYLOG_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../Points/SetOfPoints/PointVals/PointVal.h"
+#include "../Points/SetOfPoints/SetOfPoints.h"
+#include "StateWithMemory.h"
+
+namespace OptLib
+{
+	namespace StateWithMemory
+	{
+		namespace LogDetail
+		{
+			// "OPTT"
+			constexpr std::uint32_t Magic = 0x5454504Fu;
+			constexpr std::uint32_t Version = 1;
+
+			/// @brief Records of a block stored by columns: the update numbers, the evaluations, then every coordinate
+			/// and the value of every point. Column c = j (dim + 1) + i holds the i-th coordinate of the j-th point,
+			/// i == dim is its value. On disk a block is N followed by the full columns, so all the blocks have one size
+			template<size_t dim, size_t count>
+			struct Block
+			{
+				constexpr static size_t columns = count * (dim + 1);
+
+				std::uint64_t N{ 0 };
+				std::vector<std::uint64_t> Iteration;
+				std::vector<std::uint64_t> Evaluations;
+				std::vector<double> Cols;
+
+				explicit Block(size_t size) : Iteration(size), Evaluations(size), Cols(columns * size) {}
+
+				size_t Capacity() const { return Iteration.size(); }
+
+				void Put(size_t it, size_t evaluations, const SetOfPoints<count, PointVal<dim>>& p)
+				{
+					const size_t k = N++;
+					const size_t B = Capacity();
+					Iteration[k] = it;
+					Evaluations[k] = evaluations;
+					for (size_t j = 0; j < count; ++j)
+					{
+						double* c = Cols.data() + j * (dim + 1) * B + k;
+						for (size_t i = 0; i < dim; ++i)
+							c[i * B] = p[j].P[i];
+						c[dim * B] = p[j].Val;
+					}
+				}
+
+				Snapshot<dim, count> Get(size_t k) const
+				{
+					const size_t B = Capacity();
+					Snapshot<dim, count> out;
+					out.Iteration = Iteration[k];
+					out.Evaluations = Evaluations[k];
+					for (size_t j = 0; j < count; ++j)
+					{
+						const double* c = Cols.data() + j * (dim + 1) * B + k;
+						for (size_t i = 0; i < dim; ++i)
+							out.Points[j].P[i] = c[i * B];
+						out.Points[j].Val = c[dim * B];
+					}
+					return out;
+				}
+
+				template<typename stream>
+				void Bytes(stream& s, void* p, size_t n) const
+				{
+					if constexpr (requires { s.write(nullptr, 0); })
+						s.write(static_cast<const char*>(p), static_cast<std::streamsize>(n));
+					else
+						s.read(static_cast<char*>(p), static_cast<std::streamsize>(n));
+				}
+
+				/// @brief Writes the block to an ostream or reads it from an istream
+				template<typename stream>
+				void Transfer(stream& s)
+				{
+					Bytes(s, &N, sizeof(N));
+					Bytes(s, Iteration.data(), Iteration.size() * sizeof(std::uint64_t));
+					Bytes(s, Evaluations.data(), Evaluations.size() * sizeof(std::uint64_t));
+					Bytes(s, Cols.data(), Cols.size() * sizeof(double));
+				}
+			};
+
+			struct Header
+			{
+				std::uint32_t Magic;
+				std::uint32_t Version;
+				std::uint32_t Dim;
+				std::uint32_t Count;
+				std::uint64_t BlockSize;
+			};
+		} // LogDetail
+
+		/// @brief Append-only binary log of a trajectory for the offline analysis of long runs, read back by TrajectoryLogReader.
+		/// The records are collected in blocks of a fixed layout, see LogDetail::Block, in the native byte order.
+		/// A full block is handed over to a writer thread, so Append only copies the record: it never waits for the disk.
+		/// If the disk falls behind, more blocks are allocated instead of waiting
+		/// @tparam count 1 for the guess of a point state, dim + 1 for the domain of a simplex state
+		template<size_t dim, size_t count = 1>
+		class TrajectoryLog
+		{
+		public:
+			using block_type = LogDetail::Block<dim, count>;
+
+			/// @param blockSize Records per block, about 1000 keeps a write large and the loss on a crash small
+			explicit TrajectoryLog(const std::string& path, size_t blockSize = 1024) :
+				Out{ path, std::ios::binary | std::ios::trunc },
+				Size{ std::max<size_t>(blockSize, 1) },
+				Current{ std::make_unique<block_type>(Size) }
+			{
+				LogDetail::Header h{ LogDetail::Magic, LogDetail::Version, static_cast<std::uint32_t>(dim), static_cast<std::uint32_t>(count), static_cast<std::uint64_t>(Size) };
+				Out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+				if (!Out)
+					Failed = true;
+				for (int i = 0; i < 2; ++i)
+					Free.push_back(std::make_unique<block_type>(Size));
+				Writer = std::thread{ [this]() { Run(); } };
+			}
+
+			TrajectoryLog(const TrajectoryLog&) = delete;
+			TrajectoryLog& operator=(const TrajectoryLog&) = delete;
+
+			~TrajectoryLog() { Close(); }
+
+			/// @brief False if the file could not be opened or a write failed
+			bool Good() const { return !Failed.load(std::memory_order_relaxed); }
+
+			/// @brief Records the points p after the update it, when f has been called evaluations times
+			void Append(size_t it, size_t evaluations, const SetOfPoints<count, PointVal<dim>>& p)
+			{
+				Current->Put(it, evaluations, p);
+				if (Current->N == Size)
+					Handover();
+			}
+
+			/// @brief Records the domain of a simplex state or the guess of any other state
+			template<typename state>
+				requires requires (const state& s) { s.Guess(); }
+			void Append(size_t it, size_t evaluations, const state& State)
+			{
+				if constexpr (count == 1)
+					Append(it, evaluations, SetOfPoints<1, PointVal<dim>>{ State.Guess() });
+				else
+					Append(it, evaluations, State.GuessDomain());
+			}
+
+			/// @brief Writes the records appended so far and waits for the writer
+			void Flush()
+			{
+				if (Current->N > 0)
+					Handover();
+				std::unique_lock<std::mutex> lock{ M };
+				Drained.wait(lock, [this]() { return Pending == 0; });
+				Out.flush(); // the writer is idle until the next handover
+				if (!Out)
+					Failed = true;
+			}
+
+			/// @brief Flushes and stops the writer. Nothing may be appended after it
+			void Close()
+			{
+				if (!Writer.joinable())
+					return;
+				Flush();
+				{
+					std::lock_guard<std::mutex> lock{ M };
+					Stopping = true;
+				}
+				Ready.notify_one();
+				Writer.join();
+				Out.close();
+			}
+
+		protected:
+			std::ofstream Out;
+			const size_t Size;
+			// filled by the optimizer thread only
+			std::unique_ptr<block_type> Current;
+
+			std::mutex M;
+			std::condition_variable Ready;
+			std::condition_variable Drained;
+			std::deque<std::unique_ptr<block_type>> Full;
+			std::vector<std::unique_ptr<block_type>> Free;
+			size_t Pending{ 0 }; // blocks queued or being written
+			bool Stopping{ false };
+			std::atomic<bool> Failed{ false };
+			std::thread Writer;
+
+			void Handover()
+			{
+				std::unique_ptr<block_type> next;
+				{
+					std::lock_guard<std::mutex> lock{ M };
+					Full.push_back(std::move(Current));
+					++Pending;
+					if (!Free.empty())
+					{
+						next = std::move(Free.back());
+						Free.pop_back();
+					}
+				}
+				Ready.notify_one();
+				Current = next ? std::move(next) : std::make_unique<block_type>(Size); // outside the lock
+			}
+
+			void Run()
+			{
+				std::unique_lock<std::mutex> lock{ M };
+				for (;;)
+				{
+					Ready.wait(lock, [this]() { return Stopping || !Full.empty(); });
+					if (Full.empty())
+						return;
+					std::unique_ptr<block_type> b{ std::move(Full.front()) };
+					Full.pop_front();
+					lock.unlock();
+
+					b->Transfer(Out);
+					if (!Out)
+						Failed = true;
+					b->N = 0;
+
+					lock.lock();
+					Free.push_back(std::move(b));
+					--Pending;
+					Drained.notify_all();
+				}
+			}
+		};
+
+		/// @brief Reads a TrajectoryLog record by record
+		template<size_t dim, size_t count = 1>
+		class TrajectoryLogReader
+		{
+		public:
+			using record_type = Snapshot<dim, count>;
+
+			explicit TrajectoryLogReader(const std::string& path) :
+				In{ path, std::ios::binary }
+			{
+				LogDetail::Header h{};
+				In.read(reinterpret_cast<char*>(&h), sizeof(h));
+				Ok = In && h.Magic == LogDetail::Magic && h.Version == LogDetail::Version &&
+					h.Dim == dim && h.Count == count && h.BlockSize > 0;
+				if (Ok)
+					Current.emplace(static_cast<size_t>(h.BlockSize));
+			}
+
+			/// @brief False if the file is not a log of this dim and count
+			bool Good() const { return Ok; }
+
+			/// @brief The next record, nothing at the end of the log
+			std::optional<record_type> Next()
+			{
+				while (Ok && Pos == Current->N)
+				{
+					Current->Transfer(In);
+					Pos = 0;
+					if (!In || Current->N > Current->Capacity())
+					{ // the end of the log, the failed read must not expose the records of the last block again
+						Current->N = 0;
+						return std::nullopt;
+					}
+				}
+				if (!Ok)
+					return std::nullopt;
+				return Current->Get(Pos++);
+			}
+
+			/// @brief Passes the rest of the records to a Trajectory, which keeps them by its own policy
+			/// @return Number of the records read
+			size_t Replay(Trajectory<dim, count>& memory)
+			{
+				size_t n = 0;
+				while (auto r = Next())
+				{
+					memory.Record(*r);
+					++n;
+				}
+				return n;
+			}
+
+		protected:
+			std::ifstream In;
+			bool Ok{ false };
+			std::optional<LogDetail::Block<dim, count>> Current;
+			size_t Pos{ 0 };
+		};
+	} // StateWithMemory
+} // OptLib
+
+#endif
@@ -0,0 +1,178 @@
+#include <cmath>
+#include <vector>
+#include <optlib/Optimizers/NDim/Annealing.h>
+#include <optlib/Optimizers/NDim/ParallelTempering.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "test_helpers.h"
+
+using namespace OptLib;
+
+TEST_CASE("PhiloxTest1", "[TestRandom]")
+{
+    // known answers of Random123
+    Random::Philox4x32::counter_type expected{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8};
+    REQUIRE(Random::Philox4x32::Block({0, 0, 0, 0}, {0, 0}) == expected);
+    expected = {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1};
+    REQUIRE(Random::Philox4x32::Block({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}) == expected);
+}
+
+TEST_CASE("RandomStreamsTest1", "[TestRandom]")
+{
+    // Discard and the block path of Fill give the same outputs as the sequential calls
+    Random::Philox4x32 a{42, 3}, b{42, 3};
+    for (int i = 0; i < 5; ++i)
+        a();
+    b.Discard(5);
+    std::vector<Random::Philox4x32::result_type> block(100);
+    b.Fill(block.data(), block.size());
+    bool same = true;
+    for (auto w : block)
+        same = same && (w == a());
+    REQUIRE(same);
+
+    // reference implementation of xoshiro256++
+    Random::Xoshiro256pp x{0};
+    x.SetRawState({1, 2, 3, 4});
+    REQUIRE(x() == 41943041);
+
+    Random::Xoshiro256pp g{11};
+    std::vector<double> z(20000);
+    Random::FillNormal(g, z.data(), z.size(), 1.0, 2.0);
+    double mean = 0.0, var = 0.0;
+    for (double v : z)
+        mean += v;
+    mean /= z.size();
+    for (double v : z)
+        var += (v - mean) * (v - mean);
+    var /= z.size();
+    REQUIRE(std::abs(mean - 1.0) < 0.05);
+    REQUIRE(std::abs(std::sqrt(var) - 2.0) < 0.05);
+}
+
+TEST_CASE("ParallelTemperingTest1", "[TestAnnealing]")
+{
+    Rastrigin<2> f{};
+    auto run = [&f]()
+    {
+        StateParams::ParallelTemperingParams<2> prm{Point<2>{3.3, -2.7}, 6, 0.05, 20.0, 0.3, 100, 50, 7};
+        auto State{prm.CreateState(&f)};
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            StateParams::ParallelTemperingParams<2>::OptAlgo::Proceed(State, &f);
+            if (State.IsConverged(1E-10, 1E-10))
+                break;
+        }
+        return State.Guess();
+    };
+    auto first{run()};
+    auto second{run()};
+    // every chain has its own stream, the runs are reproducible
+    REQUIRE(first.Val == second.Val);
+    REQUIRE(first.P[0] == second.P[0]);
+    REQUIRE(first.Val < 0.1);
+}
+
+struct Sphere : FuncInterface::IFunc<2>
+{
+    double operator()(const Point<2> &x) const override
+    {
+        return x[0] * x[0] + x[1] * x[1];
+    }
+};
+
+TEST_CASE("BatchAnnealingTest1", "[TestAnnealing]")
+{
+    Sphere f{};
+    CoolingSchedule::Geometric schedule{0.995};
+    {
+        StateParams::AnnealingParams<2> prm{Point<2>{3.3, -2.7}, 0.5, 10.0, 1E-3, schedule, 5};
+        auto State{prm.CreateState(&f)};
+        while (!State.IsConverged(1E-3, 0.0))
+            StateParams::AnnealingParams<2>::OptAlgo::Proceed(State, &f);
+        // the value of the guess is the value at its point
+        REQUIRE(std::abs(State.Guess().Val - f(State.Guess().P)) < 1E-12);
+        REQUIRE(State.bestGuess.Val <= State.Guess().Val);
+    }
+    for (auto acceptance : {ConcreteState::BatchAcceptance::Sequential, ConcreteState::BatchAcceptance::MultipleTry})
+    {
+        auto run = [&]()
+        {
+            StateParams::BatchAnnealingParams<2> prm{Point<2>{3.3, -2.7}, 0.5, 10.0, 1E-3, schedule, 8, acceptance, 5};
+            auto State{prm.CreateState(&f)};
+            while (!State.IsConverged(1E-3, 0.0))
+                StateParams::BatchAnnealingParams<2>::OptAlgo::Proceed(State, &f);
+            return State.bestGuess;
+        };
+        auto first{run()};
+        auto second{run()};
+        // the random draws are made by one thread, the runs are reproducible
+        REQUIRE(first.Val == second.Val);
+        REQUIRE(first.Val < 0.05);
+    }
+}
+
+TEST_CASE("CoolingScheduleTest1", "[TestAnnealing]")
+{
+    CoolingSchedule::Logarithmic log{};
+    log.Start(3.0);
+    REQUIRE(std::abs(log.Next(0.0, 0) - 3.0) < 1E-15);
+    CoolingSchedule::LundyMees lm{0.5};
+    REQUIRE(std::abs(lm.Next(2.0, 1) - 1.0) < 1E-15);
+    CoolingSchedule::Custom custom{[](double T, size_t k) { return T / static_cast<double>(k + 1); }};
+    REQUIRE(custom.Next(4.0, 1) == 2.0);
+
+    // the proposal is much too wide for the basin, the adaptive schedule narrows it
+    Sphere f{};
+    using schedule = CoolingSchedule::AdaptiveStep<CoolingSchedule::Geometric>;
+    StateParams::AnnealingParams<2, schedule> prm{Point<2>{3.3, -2.7}, 50.0, 1.0, 1E-4, schedule{{0.995}}, 3};
+    auto State{prm.CreateState(&f)};
+    while (!State.IsConverged(1E-4, 0.0))
+        StateParams::AnnealingParams<2, schedule>::OptAlgo::Proceed(State, &f);
+    REQUIRE(State.Step() < 1.0);
+    REQUIRE(State.bestGuess.Val < 1E-3);
+}
+
+TEST_CASE("AnnealingAskTellTest1", "[TestAnnealing]")
+{
+    Rastrigin<2> f{};
+    CoolingSchedule::Geometric schedule{0.99};
+    {
+        StateParams::AnnealingParams<2> prm{Point<2>{3.3, -2.7}, 0.5, 10.0, 1E-2, schedule, 5};
+        auto State{prm.CreateState(&f)};
+        ConcreteOptimizer::AnnealingAskTell<2> at{prm};
+        TellValues(at, &f);
+        while (!State.IsConverged(1E-2, 0.0))
+        {
+            StateParams::AnnealingParams<2>::OptAlgo::Proceed(State, &f);
+            TellValues(at, &f);
+        }
+        REQUIRE(at.IsConverged(1E-2, 0.0));
+        REQUIRE(State.Guess().Val == at.Guess().Val);
+        REQUIRE(State.bestGuess.Val == at.State().bestGuess.Val);
+    }
+    for (auto acceptance : {ConcreteState::BatchAcceptance::Sequential, ConcreteState::BatchAcceptance::MultipleTry})
+    {
+        StateParams::BatchAnnealingParams<2> prm{Point<2>{3.3, -2.7}, 0.5, 10.0, 1E-2, schedule, 8, acceptance, 5};
+        auto State{prm.CreateState(&f)};
+        ConcreteOptimizer::BatchAnnealingAskTell<2> at{prm};
+        TellValues(at, &f);
+        while (!State.IsConverged(1E-2, 0.0))
+            StateParams::BatchAnnealingParams<2>::OptAlgo::Proceed(State, &f);
+        while (!at.IsConverged(1E-2, 0.0))
+            TellValues(at, &f);
+        REQUIRE(State.Guess().Val == at.Guess().Val);
+        REQUIRE(State.bestGuess.Val == at.State().bestGuess.Val);
+    }
+}
+
+TEST_CASE("AnnealingCheckpointTest1", "[TestAnnealing]")
+{
+    Rastrigin<2> f{};
+    // the generator and the window of the adaptive schedule are restored in the middle of the cooling
+    using schedule = CoolingSchedule::AdaptiveStep<CoolingSchedule::Geometric>;
+    REQUIRE(ResumesExactly(StateParams::AnnealingParams<2, schedule>{Point<2>{3.3, -2.7}, 2.0, 10.0, 1E-3, schedule{{0.99}}, 5}, &f, 123, 500));
+    REQUIRE(ResumesExactly(StateParams::BatchAnnealingParams<2>{Point<2>{3.3, -2.7}, 0.5, 10.0, 1E-3, CoolingSchedule::Geometric{0.99}, 8, ConcreteState::BatchAcceptance::MultipleTry, 5}, &f, 50, 200));
+    REQUIRE(ResumesExactly(StateParams::ParallelTemperingParams<2>{Point<2>{3.3, -2.7}, 6, 0.05, 20.0, 0.3, 100, 50, 7}, &f, 5, 20));
+}
@@ -0,0 +1,142 @@
+#include <cmath>
+#include <vector>
+#include <optlib/Functions/Rozenbrock.h>
+#include <optlib/Optimizers/NDim/CMAES.h>
+#include <optlib/Optimizers/NDim/DifferentialEvolution.h>
+#include <optlib/Optimizers/NDim/ParticleSwarm.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "test_helpers.h"
+
+using namespace OptLib;
+
+/// @brief Axis-aligned ill-conditioned ellipsoid with the condition number 1e6
+template <size_t dim>
+struct Ellipsoid : FuncInterface::IFunc<dim>
+{
+    double operator()(const Point<dim> &x) const override
+    {
+        double s = 0.0;
+        for (size_t i = 0; i < dim; ++i)
+            s += std::pow(1E6, static_cast<double>(i) / (dim - 1)) * x[i] * x[i];
+        return s;
+    }
+};
+
+template <size_t dim>
+Point<dim> Filled(double v)
+{
+    Point<dim> p;
+    for (auto &x : p)
+        x = v;
+    return p;
+}
+
+TEST_CASE("CMAESTest1", "[TestEvolution]")
+{
+    Ellipsoid<10> f{};
+    Point<10> x0;
+    for (auto &x : x0)
+        x = 0.5;
+    StateParams::CMAESParams<10> prm{std::move(x0), 0.3, 0, 1};
+    auto State{prm.CreateState(&f)};
+    for (size_t i = 0; i < 5000; ++i)
+    {
+        StateParams::CMAESParams<10>::OptAlgo::Proceed(State, &f);
+        if (State.IsConverged(1E-8, 0.0))
+            break;
+    }
+    REQUIRE(State.IsConverged(1E-8, 0.0));
+    REQUIRE(State.Guess().Val < 1E-10);
+    // the guess is the evaluated mean, the best offspring is kept aside
+    REQUIRE(State.Best.Val <= State.Guess().Val);
+    REQUIRE(State.Guess().Val == f(State.X[State.Lambda]));
+    for (size_t i = 0; i < 10; ++i)
+        REQUIRE(State.Guess()[i] == State.X[State.Lambda][i]);
+
+    ConcreteFunc::Rozenbrok rz{};
+    StateParams::CMAESParams<2> prm2{Point<2>{-1.5, 2.0}, 0.5, 0, 1};
+    auto State2{prm2.CreateState(&rz)};
+    for (size_t i = 0; i < 2000 && !State2.IsConverged(1E-9, 0.0); ++i)
+        StateParams::CMAESParams<2>::OptAlgo::Proceed(State2, &rz);
+    REQUIRE(std::abs(State2.Guess()[0] - 1.0) < 1E-6);
+    REQUIRE(std::abs(State2.Guess()[1] - 1.0) < 1E-6);
+}
+
+TEST_CASE("DifferentialEvolutionTest1", "[TestEvolution]")
+{
+    Rastrigin<5> f{};
+    StateParams::DifferentialEvolutionParams<5> prm{Filled<5>(-5.12), Filled<5>(5.12), 60, 0.5, 0.9, ConcreteState::DEStrategy::Rand1Bin, 3};
+    auto State{prm.CreateState(&f)};
+    for (size_t i = 0; i < 3000 && !State.IsConverged(1E-8, 0.0); ++i)
+        StateParams::DifferentialEvolutionParams<5>::OptAlgo::Proceed(State, &f);
+    REQUIRE(State.IsConverged(1E-8, 0.0));
+    REQUIRE(State.Guess().Val < 1E-10);
+
+    // current-to-best is greedy, it is checked on a unimodal function
+    Ellipsoid<5> g{};
+    StateParams::DifferentialEvolutionParams<5> prm2{Filled<5>(-5.0), Filled<5>(5.0), 40, 0.5, 0.9, ConcreteState::DEStrategy::CurrentToBest1Bin, 3};
+    auto State2{prm2.CreateState(&g)};
+    for (size_t i = 0; i < 3000 && !State2.IsConverged(1E-8, 0.0); ++i)
+        StateParams::DifferentialEvolutionParams<5>::OptAlgo::Proceed(State2, &g);
+    REQUIRE(State2.IsConverged(1E-8, 0.0));
+    REQUIRE(State2.Guess().Val < 1E-10);
+}
+
+TEST_CASE("ParticleSwarmTest1", "[TestEvolution]")
+{
+    Ellipsoid<5> f{};
+    auto run = [&f]()
+    {
+        StateParams::ParticleSwarmParams<5> prm{Filled<5>(-5.0), Filled<5>(5.0), 40};
+        auto State{prm.CreateState(&f)};
+        for (size_t i = 0; i < 3000 && !State.IsConverged(1E-9, 0.0); ++i)
+            StateParams::ParticleSwarmParams<5>::OptAlgo::Proceed(State, &f);
+        return State.Guess();
+    };
+    auto first{run()};
+    auto second{run()};
+    REQUIRE(first.Val == second.Val);
+    REQUIRE(first.Val < 1E-10);
+}
+
+TEST_CASE("PopulationAskTellTest1", "[TestEvolution]")
+{
+    Rastrigin<3> f{};
+    // one round creates the state, every next one is a generation of Proceed
+    auto check = [&f](auto prm, auto &at)
+    {
+        auto State{prm.CreateState(&f)};
+        TellValues(at, &f);
+        REQUIRE(at.Guess().Val == State.Guess().Val);
+        for (size_t i = 0; i < 50; ++i)
+            decltype(prm)::OptAlgo::Proceed(State, &f);
+        TellValues(at, &f, 50);
+        REQUIRE(at.Guess().Val == State.Guess().Val);
+        REQUIRE(at.Guess().P[0] == State.Guess().P[0]);
+    };
+    StateParams::DifferentialEvolutionParams<3> de{Filled<3>(-5.12), Filled<3>(5.12), 30, 0.5, 0.9, ConcreteState::DEStrategy::Rand1Bin, 3};
+    ConcreteOptimizer::DifferentialEvolutionAskTell<3> deAt{de};
+    REQUIRE(deAt.Ask().size() == 30); // the initial population
+    check(de, deAt);
+
+    StateParams::ParticleSwarmParams<3> pso{Filled<3>(-5.12), Filled<3>(5.12), 30};
+    ConcreteOptimizer::ParticleSwarmAskTell<3> psoAt{pso};
+    check(pso, psoAt);
+
+    StateParams::CMAESParams<3> cma{Filled<3>(2.0), 0.5, 0, 1};
+    ConcreteOptimizer::CMAESAskTell<3> cmaAt{cma};
+    REQUIRE(cmaAt.Ask().size() == 1); // the start point
+    check(cma, cmaAt);
+}
+
+TEST_CASE("PopulationCheckpointTest1", "[TestEvolution]")
+{
+    Rastrigin<3> f{};
+    REQUIRE(ResumesExactly(StateParams::DifferentialEvolutionParams<3>{Filled<3>(-5.12), Filled<3>(5.12), 30, 0.5, 0.9, ConcreteState::DEStrategy::Rand1Bin, 3}, &f, 20, 50));
+    REQUIRE(ResumesExactly(StateParams::ParticleSwarmParams<3>{Filled<3>(-5.12), Filled<3>(5.12), 30}, &f, 20, 50));
+    // the checkpoint holds the covariance between two of its lazy decompositions
+    Ellipsoid<5> g{};
+    REQUIRE(ResumesExactly(StateParams::CMAESParams<5>{Filled<5>(2.0), 0.5, 0, 1}, &g, 37, 100));
+}
@@ -0,0 +1,292 @@
+#include <cmath>
+#include <sstream>
+#include <optlib/Functions/Himmel.h>
+#include <optlib/Functions/Rozenbrock.h>
+#include <optlib/Optimizers/NDim/ConjugateGradient.h>
+#include <optlib/Optimizers/NDim/TrustRegion.h>
+#include <optlib/Optimizers/NDim/LevenbergMarquardt.h>
+#include <optlib/Optimizers/OneDim/Dichotomy.h>
+#include <optlib/Optimizers/OneDim/Bisection.h>
+#include <optlib/Optimizers/OneDim/Brent.h>
+#include <optlib/Optimizers/OneDim/SegmentLanes.h>
+#include <optlib/Functions/Interface/FunctionWithMemory.h>
+#include <optlib/States/Checkpoint.h>
+#include <optlib/States/StateWithMemory.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace OptLib;
+
+template <typename params, typename func = FuncInterface::IFuncWithGrad<2>>
+auto RunGradient(params prm, func *f)
+{
+    auto State{prm.CreateState(f)};
+    for (size_t i = 0; i < 200; ++i)
+    {
+        params::OptAlgo::Proceed(State, f);
+        if (State.IsConverged(1E-10, 1E-10))
+            break;
+    }
+    return State.Guess();
+}
+
+TEST_CASE("LineSearchTest1", "[TestGradient]")
+{
+    ConcreteFunc::Himmel Him{};
+    // phi(0) is reused and must never be recalculated
+    ConcreteFunc::FuncAlongGradDirection<2> phi{&Him, Point<2>{1.0, 1.0}};
+    PointVal<1> left{Point<1>{0.0}, Him(Point<2>{1.0, 1.0})};
+
+    auto best{ConcreteOptimizer::LineSearch<StateParams::GoldenSectionParams>::Search(
+        &phi, left, 1.0E-2, 60, 1.0E-12)};
+    REQUIRE(best.Val < left.Val);
+    REQUIRE(std::abs(phi.grad(best.P)[0]) < 1.0E-4);
+}
+
+TEST_CASE("SteepestDescentTest1", "[TestGradient]")
+{
+    ConcreteFunc::Himmel Him{};
+    auto gs{RunGradient(StateParams::SteepestDescentParams<2>{Point<2>{1.0, 1.0}}, &Him)};
+    auto dich{RunGradient(StateParams::SteepestDescentParams<2, StateParams::DichotomyParams>{Point<2>{1.0, 1.0}}, &Him)};
+    auto bis{RunGradient(StateParams::SteepestDescentParams<2, StateParams::BisectionParams>{Point<2>{1.0, 1.0}}, &Him)};
+    auto brent{RunGradient(StateParams::SteepestDescentParams<2, StateParams::BrentParams>{Point<2>{1.0, 1.0}}, &Him)};
+    for (const auto &res : {gs, dich, bis, brent})
+    {
+        REQUIRE(dist(res.P, Point<2>{3.0, 2.0}) < 1.0E-6);
+        REQUIRE(res.Val < 1.0E-10);
+    }
+}
+
+TEST_CASE("ConjugateGradientTest1", "[TestGradient]")
+{
+    ConcreteFunc::Himmel Him{};
+    auto pr{RunGradient(StateParams::ConjugateGradientParams<2>{Point<2>{1.0, 1.0}}, &Him)};
+    auto fr{RunGradient(StateParams::ConjugateGradientParams<2, ConcreteOptimizer::FletcherReeves>{Point<2>{1.0, 1.0}}, &Him)};
+    for (const auto &res : {pr, fr})
+    {
+        REQUIRE(dist(res.P, Point<2>{3.0, 2.0}) < 1.0E-6);
+        REQUIRE(res.Val < 1.0E-10);
+    }
+}
+
+TEST_CASE("TrustRegionTest1", "[TestGradient]")
+{
+    ConcreteFunc::Rozenbrok Rz{};
+    ConcreteFunc::Himmel Him{};
+    auto cg{RunGradient(StateParams::TrustRegionParams<2>{Point<2>{-1.2, 1.0}}, &Rz)};
+    auto dogleg{RunGradient(StateParams::TrustRegionParams<2, ConcreteState::DoglegStep<2>>{Point<2>{-1.2, 1.0}}, &Rz)};
+    for (const auto &res : {cg, dogleg})
+    {
+        REQUIRE(dist(res.P, Point<2>{1.0, 1.0}) < 1.0E-6);
+        REQUIRE(res.Val < 1.0E-12);
+    }
+    // far from the minima, where the Hessian is indefinite on the way
+    auto far{RunGradient(StateParams::TrustRegionParams<2>{Point<2>{-20.0, 25.0}}, &Him)};
+    REQUIRE(far.Val < 1.0E-10);
+
+    // with Eta > 1/4 a rejected step with 1/4 <= rho <= Eta must not be retried with the same radius
+    StateParams::TrustRegionParams<2> strict{Point<2>{-1.2, 1.0}, 1.0, 100.0, 0.9};
+    auto State{strict.CreateState(&Rz)};
+    size_t rejected = 0;
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        const double r = State.Radius();
+        const double v = State.Guess().Val;
+        StateParams::TrustRegionParams<2>::OptAlgo::Proceed(State, &Rz);
+        if (State.Guess().Val == v)
+        {
+            ++rejected;
+            REQUIRE(State.Radius() < r);
+        }
+        if (State.IsConverged(1E-12, 1E-12))
+            break;
+    }
+    REQUIRE(rejected > 0);
+    REQUIRE(dist(State.Guess().P, Point<2>{1.0, 1.0}) < 1.0E-6);
+}
+
+// a exp(-b x) + c with the batch path written as one vectorized loop
+class ExpDecay : public FuncParamInterface::IFuncParamWithGrad<1, 3>
+{
+public:
+    using FuncParamInterface::IFuncParamWithGrad<1, 3>::operator();
+    using FuncParamInterface::IFuncParamWithGrad<1, 3>::GradP;
+
+    double operator()(const Point<1> &x, const Point<3> &a) const override
+    {
+        return a[0] * std::exp(-a[1] * x[0]) + a[2];
+    }
+    Grad<3> GradP(const Point<1> &x, const Point<3> &a) const override
+    {
+        double e = std::exp(-a[1] * x[0]);
+        return Grad<3>{e, -a[0] * x[0] * e, 1.0};
+    }
+    void GradP(const Point<1> *x, const Point<3> &a, double *out, double *J, size_t n) const override
+    {
+#pragma omp simd
+        for (size_t k = 0; k < n; ++k)
+        {
+            double e = std::exp(-a[1] * x[k][0]);
+            out[k] = a[0] * e + a[2];
+            J[k] = e;
+            J[n + k] = -a[0] * x[k][0] * e;
+            J[2 * n + k] = 1.0;
+        }
+    }
+};
+
+TEST_CASE("LevenbergMarquardtTest1", "[TestGradient]")
+{
+    ExpDecay model{};
+    const Point<3> exact{5.0, 0.7, -1.0};
+    const size_t N = 10000; // not a multiple of the chunk
+    std::vector<Point<1>> x(N);
+    std::vector<double> y(N);
+    for (size_t k = 0; k < N; ++k)
+    {
+        x[k] = Point<1>{10.0 * k / N};
+        y[k] = model(x[k], exact);
+    }
+    ConcreteFunc::LeastSquares<1, 3> F{&model, std::move(x), std::move(y)};
+
+    // the fused pass gives the same objective as the values alone
+    Hess<3> JtJ;
+    Grad<3> Jtr;
+    const Point<3> a0{1.0, 3.0, 0.0};
+    REQUIRE(std::abs(F.Normal(a0, JtJ, Jtr) - F(a0)) < 1.0E-9 * F(a0));
+
+    StateParams::LevenbergMarquardtParams<1, 3> prm{Point<3>{1.0, 3.0, 0.0}};
+    auto State{prm.CreateState(&F)};
+    size_t it = 0;
+    for (; it < 100; ++it)
+    {
+        ConcreteOptimizer::LevenbergMarquardt<1, 3>::Proceed(State, &F);
+        if (State.IsConverged(1E-12, 1E-12))
+            break;
+    }
+    REQUIRE(it < 50);
+    REQUIRE(dist(State.Guess().P, exact) < 1.0E-8);
+    REQUIRE(State.Guess().Val < 1.0E-16);
+}
+
+TEST_CASE("BrentTest1", "[TestGradient]")
+{
+    ConcreteFunc::Himmel Him{};
+    ConcreteFunc::FuncAlongGradDirection<2> phi{&Him, Point<2>{1.0, 1.0}};
+
+    auto run = [&phi](auto prm)
+    {
+        FunctWithCounter::ICounterFunc<1> f{&phi};
+        auto State{prm.CreateState(&f)};
+        for (size_t i = 0; i < 200 && !State.IsConverged(1E-8, 1E-8); ++i)
+            decltype(prm)::OptAlgo::Proceed(State, &f);
+        return std::pair{State.Guess(), f.Counter.load()};
+    };
+    auto [brent, brentCount] = run(StateParams::BrentParams{SetOfPoints<2, Point<1>>{Point<1>{0.0}, Point<1>{0.16}}});
+    auto [gs, gsCount] = run(StateParams::GoldenSectionParams{SetOfPoints<2, Point<1>>{Point<1>{0.0}, Point<1>{0.16}}});
+
+    REQUIRE(std::abs(phi.grad(brent.P)[0]) < 1.0E-4);
+    REQUIRE(brent.Val <= gs.Val + 1.0E-10);
+    REQUIRE(2 * brentCount < gsCount);
+}
+
+struct ShiftedQuartics : FuncInterface::IFuncLanes<8>
+{
+    FuncInterface::Lanes<8> c{-0.3, -0.2, -0.1, 0.0, 0.1, 0.2, 0.3, 0.4};
+    void operator()(const FuncInterface::Lanes<8> &x, FuncInterface::Lanes<8> &out) const override
+    {
+        for (size_t i = 0; i < 8; ++i)
+        {
+            double d = x[i] - c[i];
+            out[i] = d * d * (1.0 + 0.1 * d * d);
+        }
+    }
+};
+
+template <typename params>
+void CheckLanes(params prm, ShiftedQuartics &f)
+{
+    auto State{prm.CreateState(&f)};
+    for (size_t i = 0; i < 200 && State.ActiveCount() > 0; ++i)
+        params::OptAlgo::Proceed(State, &f);
+    REQUIRE(State.IsConverged(1E-9, 1E-9));
+    for (size_t i = 0; i < 8; ++i)
+        REQUIRE(std::abs(State.Guess(i).P[0] - f.c[i]) < 1.0E-8);
+}
+
+TEST_CASE("SegmentLanesTest1", "[TestGradient]")
+{
+    ShiftedQuartics f{};
+    FuncInterface::Lanes<8> a{}, b{};
+    a.fill(-2.0);
+    b.fill(3.0);
+    b[3] = 0.05; // the lanes converge at different iterations
+    CheckLanes(StateParams::GoldenSectionLanesParams<8>{a, b, 1E-10, 1E-10}, f);
+    CheckLanes(StateParams::DichotomyLanesParams<8>{a, b, 1E-10, 1E-10}, f);
+    CheckLanes(StateParams::BisectionLanesParams<8>{a, b, 1E-10, 1E-10}, f);
+}
+
+TEST_CASE("GradientCheckpointTest1", "[TestGradient]")
+{
+    // a checkpoint after every iteration count, some of them right after a rejected step, where the subproblem is reused
+    auto resumes = [](auto prm, auto *f, auto restore, size_t before)
+    {
+        using params = decltype(prm);
+        auto State{params{prm}.CreateState(f)};
+        for (size_t i = 0; i < before; ++i)
+            params::OptAlgo::Proceed(State, f);
+        std::stringstream buf;
+        Checkpoint::Save(State, buf);
+        auto Restored{restore(prm, buf)};
+        if (!Restored)
+            return false;
+        for (size_t i = 0; i < 30; ++i)
+        {
+            params::OptAlgo::Proceed(State, f);
+            params::OptAlgo::Proceed(*Restored, f);
+        }
+        return State.Guess().Val == Restored->Guess().Val && State.Guess().P[0] == Restored->Guess().P[0];
+    };
+    auto placeholder = [](auto prm, std::istream &in) { return Checkpoint::Restore(prm, in); };
+
+    ConcreteFunc::Rozenbrok Rz{};
+    bool same = true;
+    for (size_t before = 0; before < 12; ++before)
+    {
+        same = same && resumes(StateParams::TrustRegionParams<2>{Point<2>{-1.2, 1.0}}, &Rz, placeholder, before);
+        same = same && resumes(StateParams::TrustRegionParams<2, ConcreteState::DoglegStep<2>>{Point<2>{-1.2, 1.0}}, &Rz, placeholder, before);
+        same = same && resumes(StateParams::ConjugateGradientParams<2>{Point<2>{-1.2, 1.0}}, &Rz, placeholder, before);
+    }
+    REQUIRE(same);
+
+    // the least-squares state is created on its objective, which is evaluated once and overwritten
+    ExpDecay model{};
+    std::vector<Point<1>> x(500);
+    std::vector<double> y(500);
+    for (size_t k = 0; k < x.size(); ++k)
+    {
+        x[k] = Point<1>{0.02 * k};
+        y[k] = model(x[k], Point<3>{5.0, 0.7, -1.0}) + 0.01 * std::sin(13.0 * k);
+    }
+    ConcreteFunc::LeastSquares<1, 3> F{&model, std::move(x), std::move(y)};
+    auto onF = [&F](auto prm, std::istream &in) { return Checkpoint::Restore(prm, in, &F); };
+    REQUIRE(resumes(StateParams::LevenbergMarquardtParams<1, 3>{Point<3>{1.0, 3.0, 0.0}}, &F, onF, 4));
+}
+
+TEST_CASE("PointMemoryTest1", "[TestGradient]")
+{
+    ConcreteFunc::Rozenbrok Rz{};
+    using params = StateParams::ConjugateGradientParams<2>;
+    using memory = StateWithMemory::StatePointMemory<params::StateType>;
+    // the last 8 moves
+    memory State{params{Point<2>{-1.2, 1.0}}.CreateState(&Rz), memory::memory_type{8}};
+    for (size_t i = 0; i < 30; ++i)
+        params::OptAlgo::Proceed(State, &Rz);
+    const auto &m = State.Memory();
+    REQUIRE(m.Updates() > 8);
+    REQUIRE(m.Size() == 8);
+    REQUIRE(m.Last().Iteration == m.Updates() - 1);
+    REQUIRE(m[0].Iteration == m.Updates() - 8);
+    REQUIRE(m.Last().Points[0].Val == State.Guess().Val);
+    REQUIRE(m[6].Points[0].Val >= m.Last().Points[0].Val);
+}
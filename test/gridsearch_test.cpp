@@ -0,0 +1,40 @@
+#include <limits>
+#include <optlib/Functions/Himmel.h>
+#include <optlib/Optimizers/NDim/GridSearch.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace OptLib;
+
+TEST_CASE("GridSearchTest1", "[TestGridSearch]")
+{
+    ConcreteFunc::Himmel Him{};
+    // the tile size does not divide the number of nodes
+    StateParams::GridSearchParams<2> prm{Point<2>{-5.0, -5.0}, Point<2>{5.0, 5.0}, 101, true, 97};
+    auto State{prm.CreateState(&Him)};
+    for (size_t i = 0; i < 100 && !State.IsConverged(1E-9, 1E-9); ++i)
+        StateParams::GridSearchParams<2>::OptAlgo::Proceed(State, &Him);
+    REQUIRE(State.IsConverged(1E-9, 1E-9));
+    REQUIRE(State.Guess().Val < 1.0E-12);
+}
+
+TEST_CASE("GridSearchNodesTest1", "[TestGridSearch]")
+{
+    // 10^20 nodes do not fit in size_t, the number per axis is clamped
+    using state = ConcreteState::StateGridSearch<20>;
+    REQUIRE(state::MaxNodes() == 8);
+    REQUIRE(state::Fits(8));
+    REQUIRE(!state::Fits(9));
+    REQUIRE(!state::Fits(10));
+
+    struct Zero : public FuncInterface::IFunc<20>
+    {
+        double operator()(const Point<20> &) const override { return 0.0; }
+    } f;
+    StateParams::GridSearchParams<20> prm{Point<20>{}, Point<20>{}, 10};
+    auto State{prm.CreateState(&f)};
+    REQUIRE(State.Nodes == 8);
+
+    REQUIRE(ConcreteState::StateGridSearch<1>::MaxNodes() == static_cast<size_t>(std::numeric_limits<long long>::max()));
+    REQUIRE(ConcreteState::StateGridSearch<2>::MaxNodes() == 3037000499ULL);
+}
@@ -0,0 +1,662 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <optlib/Functions/Himmel.h>
+#include <optlib/Optimizers/NDim/NelderMeadParallel.h>
+#include <optlib/Optimizers/OneDim/GoldenSection.h>
+#include <optlib/Optimizers/OneDim/Bisection.h>
+#include <optlib/Optimizers/MultiStart.h>
+#include <optlib/Optimizers/OverallOptimizer.h>
+#include <optlib/Optimizers/Observers.h>
+#include <optlib/Functions/Interface/FunctionWithMemory.h>
+#include <optlib/States/Checkpoint.h>
+#include <optlib/States/StateWithMemory.h>
+#include <optlib/States/TrajectoryLog.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "test_helpers.h"
+
+using namespace OptLib;
+
+template <typename params>
+auto RunNelderMead(FuncInterface::IFunc<2> *f)
+{
+    auto State{StartSimplex<params>().CreateState(f)};
+    for (size_t i = 0; i < 1000 && !State.IsConverged(1E-9, 1E-9); ++i)
+        params::OptAlgo::Proceed(State, f);
+    return State.Guess();
+}
+
+TEST_CASE("NelderMeadTest1", "[TestNelderMead]")
+{
+    ConcreteFunc::Himmel Him{};
+    auto res{RunNelderMead<StateParams::NelderMeadParams<2>>(&Him)};
+    REQUIRE(dist(res.P, Point<2>{-2.805118, 3.131312}) < 1.0E-5);
+}
+
+TEST_CASE("NelderMeadSpeculativeTest1", "[TestNelderMead]")
+{
+    ConcreteFunc::Himmel Him{};
+    // the speculative evaluation must not change the trajectory
+    auto serial{RunNelderMead<StateParams::NelderMeadParams<2>>(&Him)};
+    auto spec{RunNelderMead<StateParams::NelderMeadSpeculativeParams<2>>(&Him)};
+    REQUIRE(serial.P[0] == spec.P[0]);
+    REQUIRE(serial.P[1] == spec.P[1]);
+    REQUIRE(serial.Val == spec.Val);
+}
+
+TEST_CASE("NelderMeadMultiVertexTest1", "[TestNelderMead]")
+{
+    ConcreteFunc::Himmel Him{};
+    // the workers are clamped to dim / 2, and a single worker is exactly the serial method
+    REQUIRE(StartSimplex<StateParams::NelderMeadMultiVertexParams<2>>(size_t{4}).CreateState(&Him).Workers == 1);
+    auto multi{RunNelderMead<StateParams::NelderMeadMultiVertexParams<2>>(&Him)};
+    auto serial{RunNelderMead<StateParams::NelderMeadParams<2>>(&Him)};
+    REQUIRE(serial.P[0] == multi.P[0]);
+    REQUIRE(serial.P[1] == multi.P[1]);
+}
+
+TEST_CASE("NelderMeadMultiVertexTest2", "[TestNelderMead]")
+{
+    // sum of (i + 1) (x_i - 1)^2, the simplex of several workers collapses on it without the rebuilds
+    struct WeightedSphere : public FuncInterface::IFunc<12>
+    {
+        double operator()(const Point<12> &x) const override
+        {
+            double s = 0.0;
+            for (size_t i = 0; i < 12; ++i)
+                s += (i + 1.0) * (x[i] - 1.0) * (x[i] - 1.0);
+            return s;
+        }
+    } f;
+
+    SetOfPoints<13, Point<12>> Start;
+    for (size_t j = 0; j < 13; ++j)
+    {
+        Start[j] = Point<12>{};
+        if (j > 0)
+            Start[j][j - 1] = 1.0;
+    }
+
+    StateParams::NelderMeadMultiVertexParams<12> prm{std::move(Start), 1.0, 0.5, 2.0, 6};
+    auto State{prm.CreateState(&f)};
+    REQUIRE(State.Workers == 6);
+    size_t it = 0;
+    for (; it < 100000 && !State.IsConverged(1E-10, 1E-10); ++it)
+        ConcreteOptimizer::NelderMeadMultiVertex<12>::Proceed(State, &f);
+
+    REQUIRE(it < 100000);
+    REQUIRE(State.Rebuilds > 0);
+    double err = 0.0;
+    for (size_t i = 0; i < 12; ++i)
+        err = std::max(err, std::abs(State.GuessDomain()[0].P[i] - 1.0));
+    REQUIRE(err < 1E-5);
+}
+
+TEST_CASE("NelderMeadIncrementalTest1", "[TestNelderMead]")
+{
+    ConcreteFunc::Himmel Him{};
+    auto serial{RunNelderMead<StateParams::NelderMeadParams<2>>(&Him)};
+    auto incr{RunNelderMead<StateParams::NelderMeadIncrementalParams<2>>(&Him)};
+    REQUIRE(dist(serial.P, incr.P) < 1.0E-6);
+
+    // the replaced vertex is moved to its place by binary insertion
+    SimplexValSort<3> S{
+        SimplexVal<3>{
+            PointVal<3>{Point<3>{0.0, 0.0, 0.0}, 1.0},
+            PointVal<3>{Point<3>{1.0, 0.0, 0.0}, 2.0},
+            PointVal<3>{Point<3>{0.0, 1.0, 0.0}, 3.0},
+            PointVal<3>{Point<3>{0.0, 0.0, 1.0}, 4.0}}};
+    S.Replace(3, PointVal<3>{Point<3>{1.0, 1.0, 1.0}, 1.5});
+    REQUIRE(S[0].Val == 1.0);
+    REQUIRE(S[1].Val == 1.5);
+    REQUIRE(S[2].Val == 2.0);
+    REQUIRE(S[3].Val == 3.0);
+    S.Replace(0, PointVal<3>{Point<3>{2.0, 1.0, 1.0}, 5.0});
+    REQUIRE(S[0].Val == 1.5);
+    REQUIRE(S[3].Val == 5.0);
+}
+
+TEST_CASE("SetDomainIncrementalTest1", "[TestNelderMead]")
+{
+    struct Probe : public ConcreteState::StateNelderMead<2>
+    {
+        using ConcreteState::StateNelderMead<2>::StateNelderMead;
+        size_t Since() const { return SinceRecenter; }
+    };
+    ConcreteFunc::Himmel Him{};
+    Probe State{StartSimplex<StateParams::NelderMeadParams<2>>().StartSimplex, &Him, 1.0, 0.5, 2.0};
+
+    // the worst vertex is replaced in its place, as NelderMead does before the domain is sorted
+    SimplexVal<2> Next{static_cast<const SimplexVal<2> &>(State.GuessDomain())};
+    Point<2> x{-1.5, 1.4};
+    Next[2] = PointVal<2>{x, Him(x)};
+    SimplexVal<2> Copy{Next};
+    State.SetDomain(std::move(Next));
+    REQUIRE(State.Since() == 1);
+
+    // the guess is the running mean of the domain
+    PointVal<2> avg{Copy.mean()};
+    REQUIRE(std::abs(State.Guess().Val - avg.Val) < 1E-12);
+    REQUIRE(std::abs(State.Guess().P[0] - avg.P[0]) < 1E-12);
+    REQUIRE(std::abs(State.Guess().P[1] - avg.P[1]) < 1E-12);
+    REQUIRE(State.IsConverged(1E-9, 1E-9) == false);
+
+    // a squeeze changes all but the best vertex and recalculates the statistics
+    SimplexVal<2> Squeezed{static_cast<const SimplexVal<2> &>(State.GuessDomain())};
+    for (size_t i = 1; i < 3; ++i)
+    {
+        Point<2> y{(Squeezed[i].P[0] + Squeezed[0].P[0]) / 2.0, (Squeezed[i].P[1] + Squeezed[0].P[1]) / 2.0};
+        Squeezed[i] = PointVal<2>{y, Him(y)};
+    }
+    State.SetDomain(std::move(Squeezed));
+    REQUIRE(State.Since() == 0);
+}
+
+TEST_CASE("MultiStartTest1", "[TestNelderMead]")
+{
+    ConcreteFunc::Himmel Him{};
+    MultiStartOptimizer<StateParams::NelderMeadParams<2>> opt{
+        &Him, OptimizerParams{1E-9, 1E-9, 1000}, MultiStartParams{10, 1.0}};
+    auto res{opt.Optimize(
+        16,
+        [](size_t i)
+        { return Point<2>{5.0 * std::cos(0.4 * i), 5.0 * std::sin(0.4 * i)}; },
+        [](Point<2> &&x)
+        {
+            return StateParams::NelderMeadParams<2>{
+                SetOfPoints<3, Point<2>>{x, x + Point<2>{0.5, 0.0}, x + Point<2>{0.0, 0.5}},
+                1.0, 0.5, 2.0};
+        })};
+    REQUIRE(res.Starts.size() == 16);
+    REQUIRE(res.BestStart < 16);
+    REQUIRE(res.Best.Val < 1.0E-9);
+    for (const auto &s : res.Starts)
+        REQUIRE(!(s.Result < res.Best));
+}
+
+TEST_CASE("MultiStartCancelTest1", "[TestNelderMead]")
+{
+    // the global minimum 0 at (3, 3) and a local one 5 at (-3, -3)
+    struct TwoBasins : public FuncInterface::IFunc<2>
+    {
+        double operator()(const Point<2> &x) const override
+        {
+            const double g = (x[0] - 3.0) * (x[0] - 3.0) + (x[1] - 3.0) * (x[1] - 3.0);
+            const double l = 0.5 * ((x[0] + 3.0) * (x[0] + 3.0) + (x[1] + 3.0) * (x[1] + 3.0)) + 5.0;
+            return std::min(g, l);
+        }
+    } f;
+
+#ifdef _OPENMP
+    // the starts run in their order, so the hopeless ones start after an incumbent exists
+    const int threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+#endif
+    MultiStartOptimizer<StateParams::NelderMeadParams<2>> opt{
+        &f, OptimizerParams{1E-9, 1E-9, 1000}, MultiStartParams{10, 1.0}};
+    auto res{opt.Optimize(
+        6,
+        [](size_t i)
+        { return i < 3 ? Point<2>{2.0 + 0.3 * i, 4.0} : Point<2>{-2.0 - 0.3 * i, -4.0}; },
+        [](Point<2> &&x)
+        {
+            return StateParams::NelderMeadParams<2>{
+                SetOfPoints<3, Point<2>>{x, x + Point<2>{0.5, 0.0}, x + Point<2>{0.0, 0.5}},
+                1.0, 0.5, 2.0};
+        })};
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+#endif
+
+    REQUIRE(res.BestStart < 3);
+    REQUIRE(res.Best.Val < 1.0E-9);
+    size_t finished = 0;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        REQUIRE(res.Starts[i].Converged);
+        REQUIRE(!res.Starts[i].Cancelled);
+        finished = std::max(finished, res.Starts[i].Iterations);
+    }
+    // the starts in the basin of the local minimum are cut long before they converge
+    REQUIRE(std::any_of(res.Starts.cbegin(), res.Starts.cend(), [](const auto &s)
+                        { return s.Cancelled; }));
+    for (size_t i = 3; i < 6; ++i)
+    {
+        REQUIRE(res.Starts[i].Cancelled);
+        REQUIRE(!res.Starts[i].Converged);
+        REQUIRE(res.Starts[i].Iterations < finished);
+        REQUIRE(res.Starts[i].Result.Val > 5.0 - 1E-9);
+    }
+}
+
+TEST_CASE("MultiStartThrowTest1", "[TestNelderMead]")
+{
+    // a failing start is reported to the caller instead of terminating the pool
+    ConcreteFunc::Himmel Him{};
+    MultiStartOptimizer<StateParams::NelderMeadParams<2>> opt{
+        &Him, OptimizerParams{1E-9, 1E-9, 1000}};
+    REQUIRE_THROWS_AS(opt.Optimize(
+                          4,
+                          [](size_t i)
+                          { return Point<2>{0.5 * i, 0.5 * i}; },
+                          [](Point<2> &&x)
+                          {
+                              if (x[0] > 1.0)
+                                  throw std::invalid_argument{"bad start"};
+                              return StateParams::NelderMeadParams<2>{
+                                  SetOfPoints<3, Point<2>>{x, x + Point<2>{0.5, 0.0}, x + Point<2>{0.0, 0.5}},
+                                  1.0, 0.5, 2.0};
+                          }),
+                      std::invalid_argument);
+}
+
+TEST_CASE("AsyncOptimizerTest1", "[TestNelderMead]")
+{
+    ConcreteFunc::Himmel Him{};
+    FunctWithCounter::ICounterFunc<2> f{&Him};
+    auto Start = StartSimplex<StateParams::NelderMeadParams<2>>;
+
+    // the same loop as the blocking one
+    auto State1{Start().CreateState(&f)};
+    Optimizer<decltype(State1)> opt1{&State1, &f, OptimizerParams{1E-9, 1E-9, 1000}};
+    auto sync{opt1.Optimize<ConcreteOptimizer::NelderMead<2>>()};
+    auto State2{Start().CreateState(&f)};
+    Optimizer<decltype(State2)> opt2{&State2, &f, OptimizerParams{1E-9, 1E-9, 1000}};
+    auto async{opt2.OptimizeAsync<ConcreteOptimizer::NelderMead<2>>().Get()};
+    REQUIRE(sync.P[0] == async.P[0]);
+    REQUIRE(sync.P[1] == async.P[1]);
+    REQUIRE(opt1.CurIterCount() == opt2.CurIterCount());
+
+    // never converges with zero tolerances, stops on cancellation
+    f.Counter = 0;
+    auto State3{Start().CreateState(&f)};
+    const size_t created = f.Counter;
+    Optimizer<decltype(State3)> opt3{&State3, &f, OptimizerParams{0.0, 0.0, 1000000000}};
+    auto h{opt3.OptimizeAsync<ConcreteOptimizer::NelderMead<2>>()};
+    while (h.Snapshot().Iterations < 100)
+        std::this_thread::yield();
+    REQUIRE(h.Snapshot().Evaluations > created);
+    h.Cancel();
+    auto res{h.Get()};
+    REQUIRE(opt3.CurIterCount() < 1000000000);
+    auto last{h.Snapshot()};
+    REQUIRE(last.Iterations == opt3.CurIterCount());
+    REQUIRE(last.Evaluations == f.Counter);
+    REQUIRE(last.Guess.Val == res.Val);
+}
+
+TEST_CASE("AskTellTest1", "[TestNelderMead]")
+{
+    ConcreteFunc::Himmel Him{};
+    ConcreteOptimizer::NelderMeadAskTell<2> nm{StartSimplex<StateParams::NelderMeadParams<2>>()};
+    REQUIRE(nm.Ask().size() == 3); // the start simplex
+    REQUIRE(nm.Ask().size() == 3); // asked again before the values are told
+    TellValues(nm, &Him);
+    for (size_t i = 0; i < 4000 && !nm.IsConverged(1E-9, 1E-9); ++i)
+        TellValues(nm, &Him);
+    // the same decisions as Proceed
+    auto serial{RunNelderMead<StateParams::NelderMeadParams<2>>(&Him)};
+    REQUIRE(serial.P[0] == nm.Guess().P[0]);
+    REQUIRE(serial.P[1] == nm.Guess().P[1]);
+
+    struct : FuncInterface::IFunc<1>
+    {
+        double operator()(const Point<1> &x) const override { return (x[0] - 0.3) * (x[0] - 0.3); }
+    } parab;
+    auto Segment = []()
+    { return StateParams::GoldenSectionParams{SetOfPoints<2, Point<1>>{Point<1>{-2.0}, Point<1>{3.0}}}; };
+    ConcreteOptimizer::GoldenSectionAskTell gs{Segment()};
+    REQUIRE(gs.Ask().size() == 4); // the ends and the inner points
+    TellValues(gs, &parab, 41);
+    auto State{Segment().CreateState(&parab)};
+    for (size_t i = 0; i < 40; ++i)
+        ConcreteOptimizer::GoldenSection::Proceed(State, &parab);
+    REQUIRE(State.Guess().P[0] == gs.Guess().P[0]);
+    REQUIRE(std::abs(gs.Guess().P[0] - 0.3) < 1E-6);
+}
+
+TEST_CASE("AskTellMisuseTest1", "[TestNelderMead]")
+{
+    ConcreteFunc::Himmel Him{};
+    ConcreteOptimizer::NelderMeadAskTell<2> nm{StartSimplex<StateParams::NelderMeadParams<2>>()};
+    REQUIRE_THROWS_AS(nm.Tell(std::vector<double>(3, 0.0)), std::logic_error); // nothing is asked
+    REQUIRE(nm.Ask().size() == 3);
+    REQUIRE_THROWS_AS(nm.Tell(std::vector<double>(2, 0.0)), std::logic_error);
+    REQUIRE(!nm.Started());
+    TellValues(nm, &Him); // the rejected values do not break the round
+    REQUIRE(nm.Started());
+    REQUIRE_THROWS_AS(nm.Tell(std::vector<double>(1, 0.0)), std::logic_error);
+
+    // params that start at another point on every creation, so the values told are not at the points of the state
+    struct Drifting : StateParams::NelderMeadParams<2>
+    {
+        int *Creations;
+        Drifting(int *c) : StateParams::NelderMeadParams<2>{::StartSimplex<StateParams::NelderMeadParams<2>>()}, Creations{c} {}
+        StateType CreateState(FuncInterface::IFunc<2> *f)
+        {
+            this->StartSimplex[0][0] += (*Creations)++;
+            return StateParams::NelderMeadParams<2>::CreateState(f);
+        }
+    };
+    class DriftingAskTell : public OptimizerInterface::AskTell<DriftingAskTell, Drifting>
+    {
+        using Base = OptimizerInterface::AskTell<DriftingAskTell, Drifting>;
+        friend Base;
+
+    public:
+        using Base::Base;
+
+    protected:
+        void Propose(std::vector<Point<2>> &) {}
+        void Complete(const double *) {}
+    };
+    int creations = 0;
+    DriftingAskTell drift{Drifting{&creations}};
+    REQUIRE_THROWS_AS(TellValues(drift, &Him), std::logic_error);
+    REQUIRE(!drift.Started());
+}
+
+TEST_CASE("OptimizerStopTest1", "[TestNelderMead]")
+{
+    ConcreteFunc::Himmel Him{};
+    FunctWithCounter::ICounterFunc<2> f{&Him};
+    auto run = [&f](OptimizerParams prm)
+    {
+        f.Counter = 0;
+        auto State{StartSimplex<StateParams::NelderMeadParams<2>>().CreateState(&f)};
+        Optimizer<decltype(State)> opt{&State, &f, prm};
+        opt.Optimize<ConcreteOptimizer::NelderMead<2>>();
+        return std::make_tuple(opt.Reason(), opt.CurIterCount(), State.Guess().Val);
+    };
+
+    auto [converged, it1, v1] = run(OptimizerParams{1E-9, 1E-9, 1000});
+    REQUIRE(converged == StopReason::Converged);
+    auto [iter, it2, v2] = run(OptimizerParams{1E-9, 1E-9, 10});
+    REQUIRE(iter == StopReason::MaxIterations);
+    REQUIRE(it2 == 10);
+
+    // eps_x alone bounds the spread of the simplex, a loose eps_f does not relax it
+    auto [loose, it7, v7] = run(OptimizerParams{1E-3, 1E-9, 1000});
+    REQUIRE(loose == StopReason::Converged);
+    REQUIRE(v7 < 1E-12);
+    // eps_f alone bounds the change of the value
+    auto [coarse, it8, v8] = run(OptimizerParams{1E-2, 1E-2, 1000});
+    auto [fine, it9, v9] = run(OptimizerParams{1E-12, 1E-2, 1000});
+    REQUIRE(coarse == StopReason::Converged);
+    REQUIRE(fine == StopReason::Converged);
+    REQUIRE(it9 > it8);
+    REQUIRE(v9 < v8);
+
+    // a Nelder-Mead iteration calls f at most dim + 2 times
+    auto [evals, it3, v3] = run(OptimizerParams{.eps_f = 1E-9, .eps_x = 1E-9, .max_iter = 1000, .max_evals = 50});
+    REQUIRE(evals == StopReason::MaxEvaluations);
+    REQUIRE(f.Counter >= 50);
+    REQUIRE(f.Counter < 54);
+
+    auto [target, it4, v4] = run(OptimizerParams{.eps_f = 1E-9, .eps_x = 1E-9, .max_iter = 1000, .target = 1.0});
+    REQUIRE(target == StopReason::Target);
+    REQUIRE(v4 <= 1.0);
+    REQUIRE(it4 < it1);
+
+    // zero tolerances never converge
+    auto [stall, it5, v5] = run(OptimizerParams{.eps_f = 0.0, .eps_x = 0.0, .max_iter = 100000, .stall_iter = 20, .stall_tol = 1E-12});
+    REQUIRE(stall == StopReason::Stagnation);
+    REQUIRE(it5 < 100000);
+    REQUIRE(v5 < 1E-10);
+
+    auto [late, it6, v6] = run(OptimizerParams{.eps_f = 1E-9, .eps_x = 1E-9, .max_iter = 1000, .deadline = std::chrono::steady_clock::now()});
+    REQUIRE(late == StopReason::Deadline);
+    REQUIRE(it6 == 0);
+
+    // max_evals cannot be enforced if f does not count its calls
+    auto State{StartSimplex<StateParams::NelderMeadParams<2>>().CreateState(&Him)};
+    Optimizer<decltype(State)> uncounted{&State, &Him, OptimizerParams{.eps_f = 1E-9, .eps_x = 1E-9, .max_iter = 1000, .max_evals = 50}};
+    REQUIRE_THROWS_AS(uncounted.Optimize<ConcreteOptimizer::NelderMead<2>>(), std::logic_error);
+    REQUIRE(uncounted.CurIterCount() == 0);
+
+    // a guess that stays for a few iterations, as that of a population, is not converged within the window
+    const OptimizerParams window{.eps_f = 1E-9, .eps_x = 1E-9, .max_iter = 1000, .eps_f_window = 3};
+    ValueWindow w{window, 2, 5.0};
+    REQUIRE(!w.Converged(5.0));
+    REQUIRE(!w.Converged(5.0));
+    REQUIRE(w.Converged(5.0));
+    REQUIRE(!w.Converged(4.0));
+    REQUIRE(!w.Converged(4.0));
+    REQUIRE(!w.Converged(4.0));
+    REQUIRE(w.Converged(4.0));
+}
+
+TEST_CASE("CheckpointTest1", "[TestNelderMead]")
+{
+    ConcreteFunc::Himmel Him{};
+    FunctWithCounter::ICounterFunc<2> f{&Him};
+    auto prm = StartSimplex<StateParams::NelderMeadIncrementalParams<2>>;
+    using algo = StateParams::NelderMeadIncrementalParams<2>::OptAlgo;
+
+    auto State{prm().CreateState(&f)};
+    for (size_t i = 0; i < 15; ++i)
+        algo::Proceed(State, &f);
+    std::stringstream buf;
+    REQUIRE(Checkpoint::Save(State, buf));
+
+    // the restored state costs no evaluation and continues the same trajectory bit for bit
+    f.Counter = 0;
+    auto Restored{Checkpoint::Restore(prm(), buf)};
+    REQUIRE(Restored.has_value());
+    REQUIRE(f.Counter == 0);
+    for (size_t i = 0; i < 40; ++i)
+    {
+        algo::Proceed(State, &f);
+        algo::Proceed(*Restored, &f);
+    }
+    bool same = true;
+    for (size_t k = 0; k < 3; ++k)
+        same = same && State.GuessDomain()[k].Val == Restored->GuessDomain()[k].Val && State.GuessDomain()[k].P[0] == Restored->GuessDomain()[k].P[0];
+    REQUIRE(same);
+    REQUIRE(State.IsConverged(1E-6, 1E-6) == Restored->IsConverged(1E-6, 1E-6));
+
+    // a checkpoint of another state type or a truncated one is rejected
+    buf.clear();
+    buf.seekg(0);
+    REQUIRE(!Checkpoint::Restore(StateParams::GoldenSectionParams{SetOfPoints<2, Point<1>>{Point<1>{0.0}, Point<1>{1.0}}}, buf).has_value());
+    std::stringstream cut{buf.str().substr(0, buf.str().size() - 1)};
+    REQUIRE(!Checkpoint::Restore(prm(), cut).has_value());
+
+    // the tags are spelled out by the states, so a checkpoint is read by a build with another compiler
+    REQUIRE(Checkpoint::Tag<ConcreteState::StateNelderMead<2>>() == 0x63024db1fe5200daULL);
+    REQUIRE(Checkpoint::Tag<ConcreteState::StateNelderMead<2>>() != Checkpoint::Tag<ConcreteState::StateNelderMead<3>>());
+    REQUIRE(Checkpoint::Tag<ConcreteState::StateNelderMead<2>>() != Checkpoint::Tag<ConcreteState::StateNelderMeadIncremental<2>>());
+
+    // the optimizer keeps its iteration counter
+    OptimizerParams limits{.eps_f = 1E-9, .eps_x = 1E-9, .max_iter = 1000};
+    auto Fresh{prm().CreateState(&f)};
+    Optimizer<decltype(Fresh)> opt{&Fresh, &f, limits};
+    opt.Optimize<algo>();
+    std::stringstream optBuf;
+    REQUIRE(Checkpoint::Save(opt, optBuf));
+    Checkpoint::Placeholder<2> none;
+    auto Resumed{prm().CreateState(&none)};
+    Optimizer<decltype(Resumed)> opt2{&Resumed, &f, limits};
+    REQUIRE(Checkpoint::Load(opt2, optBuf));
+    REQUIRE(opt2.CurIterCount() == opt.CurIterCount());
+    REQUIRE(opt2.Reason() == StopReason::Converged);
+    REQUIRE(opt2.CurrentGuess().Val == opt.CurrentGuess().Val);
+
+    // the auxiliary points of the bisection are restored with the segment
+    struct : FuncInterface::IFunc<1>
+    {
+        double operator()(const Point<1> &x) const override { return (x[0] - 0.3) * (x[0] - 0.3); }
+    } parab;
+    auto bisection = []()
+    { return StateParams::BisectionParams{SetOfPoints<2, Point<1>>{Point<1>{-1.0}, Point<1>{2.0}}}; };
+    auto Bis{bisection().CreateState(&parab)};
+    ConcreteOptimizer::Bisection::Proceed(Bis, &parab);
+    std::stringstream bisBuf;
+    REQUIRE(Checkpoint::Save(Bis, bisBuf));
+    auto Bis2{Checkpoint::Restore(bisection(), bisBuf)};
+    REQUIRE(Bis2.has_value());
+    for (size_t i = 0; i < 10; ++i)
+    {
+        ConcreteOptimizer::Bisection::Proceed(Bis, &parab);
+        ConcreteOptimizer::Bisection::Proceed(*Bis2, &parab);
+    }
+    REQUIRE(Bis.Guess().P[0] == Bis2->Guess().P[0]);
+    REQUIRE(Bis.AuxPoints[2].Val == Bis2->AuxPoints[2].Val);
+}
+
+TEST_CASE("StateWithMemoryTest1", "[TestNelderMead]")
+{
+    ConcreteFunc::Himmel f{};
+    auto prm = StartSimplex<StateParams::NelderMeadParams<2>>;
+    using memory = StateWithMemory::StateSimplexMemory<ConcreteState::StateNelderMead<2>>;
+    memory State{prm().CreateState(&f), memory::memory_type{16}};
+    auto Plain{prm().CreateState(&f)};
+    for (size_t i = 0; i < 100; ++i)
+    {
+        ConcreteOptimizer::NelderMead<2>::Proceed(State, &f);
+        ConcreteOptimizer::NelderMead<2>::Proceed(Plain, &f);
+    }
+    // the recording does not change the trajectory, the last 16 domains are kept
+    REQUIRE(State.Guess().Val == Plain.Guess().Val);
+    const auto &m = State.Memory();
+    REQUIRE(m.Size() == 16);
+    REQUIRE(m.Updates() == 101);
+    REQUIRE(m.Last().Iteration == 100);
+    REQUIRE(m[0].Iteration == 85);
+    REQUIRE(m.Last().Points[0].Val == State.GuessDomain()[0].Val);
+
+    // the decimation keeps the whole run at a coarser resolution
+    StateWithMemory::Trajectory<2, 3> coarse{8, StateWithMemory::Overflow::Decimate};
+    for (size_t i = 0; i < 100; ++i)
+        coarse.Record(State);
+    REQUIRE(coarse.Stride() == 16);
+    REQUIRE(coarse.Size() == 7);
+    bool spaced = true;
+    for (size_t i = 0; i < coarse.Size(); ++i)
+        spaced = spaced && coarse[i].Iteration == 16 * i;
+    REQUIRE(spaced);
+}
+
+TEST_CASE("TrajectoryLogTest1", "[TestNelderMead]")
+{
+    ConcreteFunc::Himmel Him{};
+    FunctWithCounter::ICounterFunc<2> f{&Him};
+    auto State{StartSimplex<StateParams::NelderMeadParams<2>>().CreateState(&f)};
+    const std::string path{(std::filesystem::temp_directory_path() / "optlib_trajectory_test.bin").string()};
+
+    StateWithMemory::Trajectory<2, 3> expected{100};
+    {
+        // a small block, so that the log has several full blocks and a partial one
+        StateWithMemory::TrajectoryLog<2, 3> log{path, 7};
+        REQUIRE(log.Good());
+        for (size_t i = 0; i < 60; ++i)
+        {
+            ConcreteOptimizer::NelderMead<2>::Proceed(State, &f);
+            log.Append(i, f.Counter, State);
+            expected.Record(State, f.Counter);
+        }
+        log.Close();
+        REQUIRE(log.Good());
+    }
+
+    StateWithMemory::TrajectoryLogReader<2, 3> reader{path};
+    REQUIRE(reader.Good());
+    StateWithMemory::Trajectory<2, 3> replayed{100};
+    REQUIRE(reader.Replay(replayed) == 60);
+    // nothing is returned again after the end
+    REQUIRE(!reader.Next().has_value());
+    REQUIRE(!reader.Next().has_value());
+    REQUIRE(reader.Replay(replayed) == 0);
+    REQUIRE(replayed.Size() == 60);
+    bool same = true;
+    for (size_t i = 0; i < 60; ++i)
+    {
+        same = same && replayed[i].Iteration == i && replayed[i].Evaluations == expected[i].Evaluations;
+        for (size_t j = 0; j < 3; ++j)
+            same = same && replayed[i].Points[j].Val == expected[i].Points[j].Val && replayed[i].Points[j].P[1] == expected[i].Points[j].P[1];
+    }
+    REQUIRE(same);
+    REQUIRE(replayed.Last().Evaluations == f.Counter);
+
+    // a log of another layout is rejected
+    StateWithMemory::TrajectoryLogReader<2, 1> other{path};
+    REQUIRE(!other.Good());
+    std::remove(path.c_str());
+}
+
+TEST_CASE("ObserverTest1", "[TestNelderMead]")
+{
+    ConcreteFunc::Himmel Him{};
+    FunctWithCounter::ICounterFunc<2> f{&Him};
+    auto create = [&f]()
+    {
+        return StartSimplex<StateParams::NelderMeadParams<2>>().CreateState(&f);
+    };
+    const OptimizerParams prm{1E-9, 1E-9, 1000};
+
+    auto Plain{create()};
+    Optimizer<decltype(Plain)> plain{&Plain, &f, prm};
+    plain.Optimize<ConcreteOptimizer::NelderMead<2>>();
+
+    f.Counter = 0;
+    auto State{create()};
+    const size_t created = f.Counter;
+    std::ostringstream trace;
+    using observer = Observers::Chain<Observers::Counters, Observers::Timing, Observers::SampledTrajectory<2, 3>, Observers::Trace>;
+    Optimizer<decltype(State), observer> opt{&State, &f, prm,
+        observer{Observers::Counters{}, Observers::Timing{}, Observers::SampledTrajectory<2, 3>{16, 2}, Observers::Trace{trace}}};
+    opt.Optimize<ConcreteOptimizer::NelderMead<2>>();
+
+    // the hooks do not change the run
+    REQUIRE(opt.Reason() == StopReason::Converged);
+    REQUIRE(opt.CurIterCount() == plain.CurIterCount());
+    REQUIRE(State.Guess().Val == Plain.Guess().Val);
+
+    const auto &counters = opt.Observer().Get<Observers::Counters>();
+    REQUIRE(counters.Runs == 1);
+    REQUIRE(counters.Iterations == opt.CurIterCount());
+    REQUIRE(counters.Evaluations == f.Counter);
+    REQUIRE(counters.Evaluations > created);
+    REQUIRE(counters.Improvements > 0);
+    REQUIRE(counters.Improvements <= counters.Iterations);
+    REQUIRE(counters.HasConverged);
+
+    const auto &timing = opt.Observer().Get<Observers::Timing>();
+    REQUIRE(timing.Iterations == opt.CurIterCount());
+    REQUIRE(timing.Max <= timing.Total);
+    REQUIRE(timing.Mean() <= timing.Max);
+
+    // the start and every second iteration, decimated to fit 16 records
+    const auto &memory = opt.Observer().Get<2>().Memory();
+    REQUIRE(memory.Size() <= 16);
+    REQUIRE(memory[0].Iteration == 0);
+    REQUIRE(created > 0); // the start record counts the calls of the creation of the state
+    REQUIRE(memory[0].Evaluations == created);
+    bool sampled = true;
+    for (size_t i = 1; i < memory.Size(); ++i)
+        sampled = sampled && memory[i].Iteration % memory.Stride() == 0 && memory[i].Iteration > memory[i - 1].Iteration;
+    REQUIRE(sampled);
+    REQUIRE(memory.Stride() >= 2);
+    REQUIRE(memory.Last().Iteration <= opt.CurIterCount());
+
+    const std::string text{trace.str()};
+    REQUIRE(text.find("Optimization started") == 0);
+    REQUIRE(text.find("Total number of iterations is s = " + std::to_string(opt.CurIterCount())) != std::string::npos);
+
+    // the default policy holds no data, unlike a policy with a state
+    static_assert(std::is_empty_v<Observers::None>);
+    static_assert(sizeof(Optimizer<decltype(State), Observers::None>) < sizeof(Optimizer<decltype(State), Observers::Counters>));
+}
@@ -0,0 +1,72 @@
+#include <cmath>
+#include <optlib/Points/SetOfPoints/PointVals/Point/PointOperators.h>
+#include <optlib/Points/SetOfPoints/SetOfPoints.h>
+#include <optlib/Points/SetOfPoints/RunningDispersion.h>
+#include <optlib/Points/SetOfPointVals.h>
+#include <optlib/Points/SetOfPoints/PointVals/PointValOperators.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace OptLib;
+
+TEST_CASE("RunningDispersionTest1", "[TestStatistics]")
+{
+    SetOfPoints<3, Point<2>> sp{
+        Point<2>{1.0, 2.0},
+        Point<2>{3.0, 2.0},
+        Point<2>{2.0, 5.0}};
+    RunningDispersion<3, Point<2>> rd{sp};
+
+    for (size_t k = 0; k < 100; ++k)
+    { // replace points one by one and compare with the exact statistics
+        Point<2> p{std::sin(1.0 * k), 1.0E3 + std::cos(2.0 * k)};
+        rd.Replace(sp[k % 3], p);
+        sp[k % 3] = p;
+
+        auto [avg, disp] = sp.dispersion();
+        auto [ravg, rdisp] = rd.dispersion();
+        for (size_t i = 0; i < 2; ++i)
+        {
+            REQUIRE(std::abs(avg[i] - ravg[i]) < 1.0E-9);
+            REQUIRE(std::abs(disp[i] - rdisp[i]) < 1.0E-7);
+        }
+    }
+}
+
+TEST_CASE("SelectionTest1", "[TestSelection]")
+{
+    std::array<double, 21> v{};
+    for (size_t i = 0; i < v.size(); ++i)
+        v[i] = std::cos(3.7 * i);
+    v[17] = -2.0;
+    v[3] = -2.0; // ties go to the smaller index
+    v[11] = 5.0;
+
+    REQUIRE(Selection::ArgMin(v) == 3);
+    REQUIRE(Selection::ArgMax(v) == 11);
+
+    auto top{Selection::TopK<4>(v)};
+    std::array<size_t, 21> order{};
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&v](size_t l, size_t r)
+                     { return v[l] < v[r]; });
+    for (size_t i = 0; i < top.size(); ++i)
+        REQUIRE(top[i] == order[i]);
+}
+
+TEST_CASE("SortingNetworkTest1", "[TestSelection]")
+{
+    SetOfPoints<13, PointVal<1>> raw;
+    for (size_t i = 0; i < 13; ++i)
+        raw[i] = PointVal<1>{Point<1>{static_cast<double>(i)}, std::round(4.0 * std::sin(1.3 * i))};
+    SetOfPointValsSort<13, PointVal<1>> sorted{raw};
+
+    auto expected{raw};
+    std::stable_sort(expected.begin(), expected.end());
+    for (size_t i = 0; i < 13; ++i)
+    {
+        REQUIRE(sorted[i].Val == expected[i].Val);
+        REQUIRE(sorted[i][0] == expected[i][0]); // the network is stable
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef TEST_HELPERS_H
+#define TEST_HELPERS_H
+
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+#include <optlib/Functions/Interface/FuncInterface.h>
+#include <optlib/Points/SetOfPoints/PointVals/Point/Point.h>
+#include <optlib/Points/SetOfPoints/SetOfPoints.h>
+#include <optlib/States/Checkpoint.h>
+
+/// @brief Rastrigin function, multimodal with the global minimum 0 at the origin
+template <size_t dim>
+struct Rastrigin : OptLib::FuncInterface::IFunc<dim>
+{
+    double operator()(const OptLib::Point<dim> &x) const override
+    {
+        double s = 10.0 * dim;
+        for (size_t i = 0; i < dim; ++i)
+            s += x[i] * x[i] - 10.0 * std::cos(2.0 * 3.14159265358979323846 * x[i]);
+        return s;
+    }
+};
+
+/// @brief Ask/tell rounds evaluated with f, as an outside evaluator would do
+template <typename driver, typename func>
+void TellValues(driver &d, const func *f, size_t rounds = 1)
+{
+    for (size_t i = 0; i < rounds; ++i)
+    {
+        const auto &x = d.Ask();
+        std::vector<double> v(x.size());
+        for (size_t k = 0; k < x.size(); ++k)
+            v[k] = (*f)(x[k]);
+        d.Tell(v);
+    }
+}
+
+/// @brief Params of a Nelder-Mead method on the start simplex of the tests on the Himmelblau function
+/// @param extra The arguments after the coefficients, e.g., the number of workers
+template <typename params, typename... T>
+params StartSimplex(T... extra)
+{
+    using OptLib::Point;
+    return params{
+        OptLib::SetOfPoints<3, Point<2>>{
+            Point<2>{-1.2, 1.0},
+            Point<2>{-1.0, 1.0},
+            Point<2>{-1.2, 1.3}},
+        1.0, 0.5, 2.0, extra...};
+}
+
+/// @brief Saves the state of prm after `before` steps, restores it and checks that both make the same `after` steps
+template <typename params, typename func>
+bool ResumesExactly(params prm, func *f, size_t before, size_t after)
+{
+    auto State{params{prm}.CreateState(f)};
+    for (size_t i = 0; i < before; ++i)
+        params::OptAlgo::Proceed(State, f);
+    std::stringstream buf;
+    if (!OptLib::Checkpoint::Save(State, buf))
+        return false;
+    auto Restored{OptLib::Checkpoint::Restore(prm, buf)};
+    if (!Restored)
+        return false;
+    for (size_t i = 0; i < after; ++i)
+    {
+        params::OptAlgo::Proceed(State, f);
+        params::OptAlgo::Proceed(*Restored, f);
+    }
+    bool same = State.Guess().Val == Restored->Guess().Val;
+    for (size_t i = 0; i < params::StateType::arg_count; ++i)
+        same = same && State.Guess().P[i] == Restored->Guess().P[i];
+    return same;
+}
+
+#endif